@@ -0,0 +1,166 @@
+#include "ScheduleBatch.h"
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <numeric>
+#include <optional>
+#include <execution>
+#include <functional>
+#include <algorithm>
+#include <exception>
+
+
+template<typename Calendar>
+std::vector<BasicScheduleBatchResult<Calendar>> SolveScheduleBatch(const std::vector<const BasicScheduleData<Calendar>*>& instances,
+                                                                   const ScheduleBatchParams& params,
+                                                                   const std::type_identity_t<BasicScheduleBatchCallback<Calendar>>& onCompleted)
+{
+    if(std::ranges::count(instances, nullptr) > 0)
+        throw std::invalid_argument("Invalid instances: must not be null");
+
+    // validate params before starting any instance
+    const BasicScheduleGA<Calendar> validatedParams(params.GAParams);
+
+    // long runs first, so that small ones fill the pool at the end
+    std::vector<std::size_t> order(instances.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(order, std::greater<>{}, [&](std::size_t i) { return instances[i]->SubjectRequests().size(); });
+
+    std::vector<std::optional<BasicScheduleBatchResult<Calendar>>> results(instances.size());
+    std::mutex completedMutex;
+    std::exception_ptr firstError;
+
+    auto solveInstance = [&](std::size_t i)
+    {
+        try
+        {
+            const auto& scheduleData = *instances[i];
+
+            ScheduleGAParams gaParams = params.GAParams;
+            gaParams.SingleThreaded = gaParams.SingleThreaded || scheduleData.SubjectRequests().size() < params.ParallelRequestsThreshold;
+
+            BasicScheduleGA<Calendar> algo(gaParams);
+            const auto statistics = algo.Start(scheduleData);
+
+            const auto& best = algo.Individuals().front();
+            BasicScheduleBatchResult<Calendar> result{
+                .Best = best.Chromosomes(),
+                .BestFitness = best.Evaluate(),
+                .Statistics = statistics
+            };
+
+            std::lock_guard lock(completedMutex);
+            if(onCompleted)
+                onCompleted(i, result);
+
+            results[i].emplace(std::move(result));
+        }
+        catch(...)
+        {
+            std::lock_guard lock(completedMutex);
+            if(!firstError)
+                firstError = std::current_exception();
+        }
+    };
+
+    // parallel algorithms give no order guarantee, so instances are handed out in sorted order from a shared index
+    // to a slot per hardware thread; nested parallel algorithms of large instances run on the same TBB pool as the slots
+    std::vector<std::size_t> slots(std::min<std::size_t>(order.size(), std::max(std::thread::hardware_concurrency(), 1u)));
+    std::atomic<std::size_t> nextInstance = 0;
+    std::for_each(std::execution::par, slots.begin(), slots.end(), [&](std::size_t)
+    {
+        for(std::size_t next = nextInstance.fetch_add(1); next < order.size(); next = nextInstance.fetch_add(1))
+            solveInstance(order[next]);
+    });
+
+    if(firstError)
+        std::rethrow_exception(firstError);
+
+    std::vector<BasicScheduleBatchResult<Calendar>> orderedResults;
+    orderedResults.reserve(results.size());
+    for(auto& result : results)
+        orderedResults.emplace_back(std::move(*result));
+
+    return orderedResults;
+}
+
+template<typename Calendar>
+BasicScheduleComponentsResult<Calendar> SolveScheduleComponents(const BasicScheduleData<Calendar>& scheduleData,
+                                                                const ScheduleBatchParams& params)
+{
+    const auto beginTime = std::chrono::steady_clock::now();
+    const auto beginCounters = CollectScheduleCounters();
+    const auto& components = scheduleData.Components();
+
+    std::vector<BasicScheduleData<Calendar>> componentsData;
+    componentsData.reserve(components.size());
+    for(const auto& component : components)
+        componentsData.emplace_back(scheduleData.ComponentData(component));
+
+    std::vector<const BasicScheduleData<Calendar>*> instances;
+    instances.reserve(componentsData.size());
+    for(const auto& componentData : componentsData)
+        instances.emplace_back(&componentData);
+
+    const auto results = SolveScheduleBatch(instances, params);
+
+    const std::size_t requestsCount = scheduleData.SubjectRequests().size();
+    std::vector<std::size_t> lessons(requestsCount);
+    std::vector<ClassroomAddress> classrooms(requestsCount);
+
+    ScheduleGAStatistics statistics{};
+    for(std::size_t c = 0; c < components.size(); ++c)
+    {
+        const auto& component = components[c];
+        const auto& componentBest = results[c].Best;
+        for(std::size_t i = 0; i < component.size(); ++i)
+        {
+            lessons[component[i]] = componentBest.Lesson(i);
+            classrooms[component[i]] = componentBest.Classroom(i);
+        }
+
+        statistics.EvaluationsCount += results[c].Statistics.EvaluationsCount;
+        statistics.LocalSearchMovesCount += results[c].Statistics.LocalSearchMovesCount;
+        statistics.LocalSearchImprovementsCount += results[c].Statistics.LocalSearchImprovementsCount;
+        statistics.LocalSearchTime += results[c].Statistics.LocalSearchTime;
+
+        // components populations live at the same time and share the thread pool,
+        // their individuals together make up one individual of the whole problem
+        const ScheduleMemoryReport& memory = results[c].Statistics.Memory;
+        statistics.Memory.IndividualsCount = std::max(statistics.Memory.IndividualsCount, memory.IndividualsCount);
+        statistics.Memory.IndividualBytes += memory.IndividualBytes;
+        statistics.Memory.PopulationBytes += memory.PopulationBytes;
+        statistics.Memory.ScheduleDataBytes += memory.ScheduleDataBytes;
+        statistics.Memory.ScratchBytesPerThread = std::max(statistics.Memory.ScratchBytesPerThread, memory.ScratchBytesPerThread);
+        statistics.Memory.ThreadsCount = std::max(statistics.Memory.ThreadsCount, memory.ThreadsCount);
+    }
+
+    // components run concurrently and counters are process-wide, so every component run already sees
+    // events of the others: counters of the whole call are taken instead of summing them
+    std::ranges::transform(CollectScheduleCounters(), beginCounters, statistics.Counters.begin(), std::minus<>{});
+    statistics.Time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginTime);
+    if(statistics.Time.count() > 0)
+        statistics.EvaluationsPerSecond = static_cast<double>(statistics.EvaluationsCount) * 1000.0 / static_cast<double>(statistics.Time.count());
+
+    // components are scored by the worst professor and group terms of the whole problem, not by their sum
+    BasicScheduleChromosomes<Calendar> best(std::move(lessons), std::move(classrooms));
+    statistics.BestEvaluation = EvaluateDetailed(best, scheduleData);
+    return BasicScheduleComponentsResult<Calendar>{
+        .Best = std::move(best),
+        .BestFitness = statistics.BestEvaluation.Fitness,
+        .ComponentsCount = components.size(),
+        .Statistics = statistics
+    };
+}
+
+
+#define INSTANTIATE_SCHEDULE_BATCH(Calendar) \
+    template std::vector<BasicScheduleBatchResult<Calendar>> SolveScheduleBatch(const std::vector<const BasicScheduleData<Calendar>*>&, \
+                                                                                const ScheduleBatchParams&, \
+                                                                                const std::type_identity_t<BasicScheduleBatchCallback<Calendar>>&); \
+    template BasicScheduleComponentsResult<Calendar> SolveScheduleComponents(const BasicScheduleData<Calendar>&, const ScheduleBatchParams&);
+
+INSTANTIATE_SCHEDULE_BATCH(DefaultScheduleCalendar)
+INSTANTIATE_SCHEDULE_BATCH(EightLessonsScheduleCalendar)
+INSTANTIATE_SCHEDULE_BATCH(OneWeekScheduleCalendar)
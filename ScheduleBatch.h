@@ -0,0 +1,65 @@
+#pragma once
+#include "ScheduleCommon.h"
+#include "ScheduleChromosomes.h"
+#include "ScheduleGA.h"
+
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+
+struct ScheduleBatchParams
+{
+    ScheduleGAParams GAParams;
+    // instances with fewer requests are solved in a single thread,
+    // larger ones spread their population over the shared thread pool
+    std::size_t ParallelRequestsThreshold = 200;
+};
+
+
+template<typename Calendar>
+struct BasicScheduleBatchResult
+{
+    BasicScheduleChromosomes<Calendar> Best;
+    std::size_t BestFitness = 0;
+    ScheduleGAStatistics Statistics;
+};
+
+template<typename Calendar>
+using BasicScheduleBatchCallback = std::function<void(std::size_t instance, const BasicScheduleBatchResult<Calendar>& result)>;
+
+using ScheduleBatchResult = BasicScheduleBatchResult<DefaultScheduleCalendar>;
+using ScheduleBatchCallback = BasicScheduleBatchCallback<DefaultScheduleCalendar>;
+
+
+// Solves independent instances with ScheduleGA on one shared thread pool, largest instances are started first.
+// onCompleted is called for every instance as soon as it is solved (never concurrently),
+// returned results are in the order of instances.
+template<typename Calendar>
+std::vector<BasicScheduleBatchResult<Calendar>> SolveScheduleBatch(const std::vector<const BasicScheduleData<Calendar>*>& instances,
+                                                                   const ScheduleBatchParams& params,
+                                                                   const std::type_identity_t<BasicScheduleBatchCallback<Calendar>>& onCompleted = {});
+
+
+template<typename Calendar>
+struct BasicScheduleComponentsResult
+{
+    BasicScheduleChromosomes<Calendar> Best;
+    std::size_t BestFitness = 0;
+    std::size_t ComponentsCount = 0;
+    ScheduleGAStatistics Statistics;
+};
+
+using ScheduleComponentsResult = BasicScheduleComponentsResult<DefaultScheduleCalendar>;
+
+
+// Solves every independent component of scheduleData as a separate batch instance
+// and merges component solutions into chromosomes of the whole problem.
+// ScheduleGA::Start does not decompose on its own: components evolve in separate populations
+// which can not be exposed as ScheduleGA::Individuals(), so decomposition is opted into by calling this function.
+// Statistics.Memory describes all component runs together: IndividualBytes is the sum of component individual sizes,
+// which is the size of one individual of the whole problem, IndividualsCount is the largest component population,
+// PopulationBytes is IndividualsCount * IndividualBytes unless ShrinkPopulationToBudget reduced some components.
+template<typename Calendar>
+BasicScheduleComponentsResult<Calendar> SolveScheduleComponents(const BasicScheduleData<Calendar>& scheduleData,
+                                                                const ScheduleBatchParams& params);
@@ -1,9 +1,14 @@
 #include "ScheduleChromosomes.h"
+#include "ScheduleCounters.h"
 #include "utils.h"
 
+#include <bit>
+#include <array>
+#include <limits>
 #include <numeric>
-
-#include <range/v3/all.hpp>
+#include <utility>
+#include <set>
+#include <tuple>
 
 
 static constexpr std::size_t NO_LESSON = std::numeric_limits<std::size_t>::max();
@@ -11,68 +16,207 @@ static constexpr std::size_t NOT_EVALUATED = std::numeric_limits<std::size_t>::m
 static constexpr std::size_t DEFAULT_BUFFER_SIZE = 1024;
 
 
-ScheduleChromosomes::ScheduleChromosomes(std::vector<std::size_t> lessons,
-                                         std::vector<ClassroomAddress> classrooms)
+template<typename Calendar>
+BasicScheduleChromosomes<Calendar>::BasicScheduleChromosomes(std::vector<std::size_t> lessons,
+                                                             std::vector<ClassroomAddress> classrooms)
     : lessons_(std::move(lessons))
     , classrooms_(std::move(classrooms))
 {
-    assert(lessons_.size() == classrooms_.size());
+    assert(Lessons().size() == Classrooms().size());
 }
 
-ScheduleChromosomes::ScheduleChromosomes(const ScheduleData& data)
-    : lessons_(data.SubjectRequests().size(), NO_LESSON)
-    , classrooms_(data.SubjectRequests().size(), ClassroomAddress::NoClassroom())
+template<typename Calendar>
+BasicScheduleChromosomes<Calendar>::BasicScheduleChromosomes(const ScheduleData& data)
+    : lessons_(std::vector<std::size_t>(data.SubjectRequests().size(), NO_LESSON))
+    , classrooms_(std::vector<ClassroomAddress>(data.SubjectRequests().size(), ClassroomAddress::NoClassroom()))
 {
     assert(!data.SubjectRequests().empty());
+    InitLockedLessons(data);
+    for(std::size_t r = 0; r < data.SubjectRequests().size(); ++r)
+        InitFromRequest(data, r);
+}
+
+template<typename Calendar>
+BasicScheduleChromosomes<Calendar>::BasicScheduleChromosomes(const ScheduleData& data, std::mt19937& randGen)
+    : lessons_(std::vector<std::size_t>(data.SubjectRequests().size(), NO_LESSON))
+    , classrooms_(std::vector<ClassroomAddress>(data.SubjectRequests().size(), ClassroomAddress::NoClassroom()))
+{
+    assert(!data.SubjectRequests().empty());
+    InitLockedLessons(data);
+
+    const auto& requests = data.SubjectRequests();
+    auto& lessons = lessons_.Mutable();
+    auto& classrooms = classrooms_.Mutable();
+
+    // conflicting requests are the ones of the same professor or of a common group
+    auto forEachConflicting = [&](std::size_t r, auto&& function)
+    {
+        for(std::size_t other : data.ProfessorsRequests()[data.RequestProfessorIndex(r)])
+            function(other);
+
+        for(std::size_t g : data.RequestGroupsIndices(r))
+        {
+            for(std::size_t other : data.GroupsRequests()[g])
+                function(other);
+        }
+    };
+
+    std::vector<std::size_t> conflictsCount(requests.size(), 0);
+    for(std::size_t r = 0; r < requests.size(); ++r)
+        forEachConflicting(r, [&](std::size_t){ ++conflictsCount[r]; });
+
+    // lessons not taken by placed conflicting requests, classrooms taken in every lesson
+    std::vector<LessonsMask> freeLessons(requests.size());
+    std::array<std::vector<ClassroomAddress>, Calendar::MaxLessonsCount> takenClassrooms;
+    for(std::size_t r = 0; r < requests.size(); ++r)
+        freeLessons[r] = data.RequestedLessons(r);
+
+    std::vector<std::mt19937::result_type> tieBreaks(requests.size());
+    std::ranges::generate(tieBreaks, randGen);
+
+    auto priority = [&](std::size_t r)
+    {
+        return std::tuple(freeLessons[r].Count(),
+                          std::numeric_limits<std::size_t>::max() - conflictsCount[r],
+                          tieBreaks[r],
+                          r);
+    };
+
+    std::set<decltype(priority(0))> queue;
+    std::vector<bool> queued(requests.size(), false);
+    for(std::size_t r = 0; r < requests.size(); ++r)
+    {
+        if(!data.RequestHasLockedLesson(r))
+        {
+            queue.insert(priority(r));
+            queued[r] = true;
+        }
+    }
+
+    auto place = [&](std::size_t r)
+    {
+        // locked lessons are validated by ScheduleData, the bound also skips not placed requests
+        const std::size_t lesson = lessons[r];
+        if(lesson >= Calendar::MaxLessonsCount)
+            return;
+
+        if(classrooms[r] != ClassroomAddress::Any() && classrooms[r] != ClassroomAddress::NoClassroom())
+            takenClassrooms[lesson].emplace_back(classrooms[r]);
+
+        forEachConflicting(r, [&](std::size_t n)
+        {
+            if(!freeLessons[n].Test(lesson))
+                return;
+
+            if(queued[n])
+                queue.erase(priority(n));
+
+            freeLessons[n].Reset(lesson);
+            if(queued[n])
+                queue.insert(priority(n));
+        });
+    };
+
+    auto freeClassroom = [&](std::size_t r, std::size_t lesson)
+    {
+        const auto& requestClassrooms = requests[r].Classrooms();
+        if(requestClassrooms.empty())
+            return ClassroomAddress::Any();
+
+        std::uniform_int_distribution<std::size_t> startDist(0, requestClassrooms.size() - 1);
+        const std::size_t start = startDist(randGen);
+        for(std::size_t i = 0; i < requestClassrooms.size(); ++i)
+        {
+            const ClassroomAddress& classroom = requestClassrooms[(start + i) % requestClassrooms.size()];
+            if(std::ranges::find(takenClassrooms[lesson], classroom) == takenClassrooms[lesson].end())
+                return classroom;
+        }
+
+        return ClassroomAddress::NoClassroom();
+    };
+
+    for(const auto& locked : data.LockedLessons())
+        place(data.IndexOfSubjectRequestWithID(locked.SubjectRequestID));
+
+    std::uniform_int_distribution<std::size_t> daysDist(0, Calendar::DaysInSchedule - 1);
+    while(!queue.empty())
+    {
+        const std::size_t r = std::get<3>(*queue.begin());
+        queue.erase(queue.begin());
+        queued[r] = false;
+
+        // earliest lesson of a day first, days are tried starting from a random one;
+        // if every free lesson lacks a classroom the earliest one is taken without a classroom
+        for(std::size_t dayLesson = 0; dayLesson < Calendar::MaxLessonsPerDay && classrooms[r] == ClassroomAddress::NoClassroom(); ++dayLesson)
+        {
+            const std::size_t startDay = daysDist(randGen);
+            for(std::size_t d = 0; d < Calendar::DaysInSchedule; ++d)
+            {
+                const std::size_t lesson = ((startDay + d) % Calendar::DaysInSchedule) * Calendar::MaxLessonsPerDay + dayLesson;
+                if(!freeLessons[r].Test(lesson))
+                    continue;
+
+                if(lessons[r] == NO_LESSON)
+                    lessons[r] = lesson;
+
+                if(const ClassroomAddress classroom = freeClassroom(r, lesson); classroom != ClassroomAddress::NoClassroom())
+                {
+                    lessons[r] = lesson;
+                    classrooms[r] = classroom;
+                    break;
+                }
+            }
+        }
+
+        place(r);
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleChromosomes<Calendar>::InitLockedLessons(const ScheduleData& data)
+{
     for(auto&& locked : data.LockedLessons())
     {
         const std::size_t r = data.IndexOfSubjectRequestWithID(locked.SubjectRequestID);
-        lessons_.at(r) = locked.Address;
+        Lesson(r) = locked.Address;
 
         auto&& request = data.SubjectRequests().at(r);
         for(auto&& classroom : request.Classrooms())
         {
             if(!ClassroomsIntersects(locked.Address, classroom))
             {
-                classrooms_.at(r) = classroom;
+                Classroom(r) = classroom;
                 break;
             }
         }
     }
-
-    for(std::size_t r = 0; r < data.SubjectRequests().size(); ++r)
-        InitFromRequest(data, r);
 }
 
-void ScheduleChromosomes::InitFromRequest(const ScheduleData& data, 
-                                          std::size_t requestIndex)
+template<typename Calendar>
+void BasicScheduleChromosomes<Calendar>::InitFromRequest(const ScheduleData& data,
+                                                         std::size_t requestIndex)
 {
-    const auto& requests = data.SubjectRequests();
-    const auto& request = requests.at(requestIndex);
-    const auto& requestClassrooms = request.Classrooms();
-    const auto& lockedLessons = data.LockedLessons();
+    const auto& requestClassrooms = data.SubjectRequests().at(requestIndex).Classrooms();
+    const LessonsMask& requestedLessons = data.RequestedLessons(requestIndex);
 
-    if(data.SubjectRequestHasLockedLesson(request))
+    if(data.RequestHasLockedLesson(requestIndex))
         return;
 
-    for(std::size_t dayLesson = 0; dayLesson < MAX_LESSONS_PER_DAY; ++dayLesson)
+    for(std::size_t dayLesson = 0; dayLesson < Calendar::MaxLessonsPerDay; ++dayLesson)
     {
-        for(std::size_t day = 0; day < DAYS_IN_SCHEDULE; ++day)
+        for(std::size_t day = 0; day < Calendar::DaysInSchedule; ++day)
         {
-            if(!request.RequestedWeekDay(day))
-                continue;
-
-            const std::size_t scheduleLesson = day * MAX_LESSONS_PER_DAY + dayLesson;
-            if(IsLateScheduleLessonInSaturday(scheduleLesson))
+            const std::size_t scheduleLesson = day * Calendar::MaxLessonsPerDay + dayLesson;
+            if(!requestedLessons.Test(scheduleLesson))
                 continue;
 
             if(GroupsOrProfessorsIntersects(data, requestIndex, scheduleLesson))
                 continue;
 
-            lessons_.at(requestIndex) = scheduleLesson;
+            Lesson(requestIndex) = scheduleLesson;
             if(requestClassrooms.empty())
             {
-                classrooms_.at(requestIndex) = ClassroomAddress::Any();
+                Classroom(requestIndex) = ClassroomAddress::Any();
                 return;
             }
 
@@ -80,7 +224,7 @@ void ScheduleChromosomes::InitFromRequest(const ScheduleData& data,
             {
                 if(!ClassroomsIntersects(scheduleLesson, classroom))
                 {
-                    classrooms_.at(requestIndex) = classroom;
+                    Classroom(requestIndex) = classroom;
                     return;
                 }
             }
@@ -88,77 +232,116 @@ void ScheduleChromosomes::InitFromRequest(const ScheduleData& data,
     }
 }
 
-bool ScheduleChromosomes::GroupsOrProfessorsOrClassroomsIntersects(const ScheduleData& data, 
-                                                                   std::size_t currentRequest,
-                                                                   std::size_t currentLesson) const
+template<typename Calendar>
+bool BasicScheduleChromosomes<Calendar>::GroupsOrProfessorsOrClassroomsIntersects(const ScheduleData& data,
+                                                                                  std::size_t currentRequest,
+                                                                                  std::size_t currentLesson) const
 {
-    if(classrooms_.at(currentRequest) == ClassroomAddress::Any())
+    if(Classroom(currentRequest) == ClassroomAddress::Any())
         return GroupsOrProfessorsIntersects(data, currentRequest, currentLesson);
 
-    const auto& requests = data.SubjectRequests();
-    const auto& thisRequest = requests.at(currentRequest);
-
-    auto it = std::find(lessons_.begin(), lessons_.end(), currentLesson);
-    while(it != lessons_.end())
+    const auto& lessons = Lessons();
+    const auto& classrooms = Classrooms();
+    std::size_t checkedRequests = 0;
+    auto it = std::find(lessons.begin(), lessons.end(), currentLesson);
+    while(it != lessons.end())
     {
-        const std::size_t requestIndex = std::distance(lessons_.begin(), it);
-        const auto& otherRequest = requests.at(requestIndex);
-        if(thisRequest.Professor() == otherRequest.Professor() || 
-           classrooms_.at(currentRequest) == classrooms_.at(requestIndex) || 
-           set_intersects(thisRequest.Groups(), otherRequest.Groups()))
+        ++checkedRequests;
+        const std::size_t requestIndex = std::distance(lessons.begin(), it);
+        if(data.RequestsConflicts(currentRequest, requestIndex) ||
+           classrooms.at(currentRequest) == classrooms.at(requestIndex))
         {
+            CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
             return true;
         }
 
-        it = std::find(std::next(it), lessons_.end(), currentLesson);
+        it = std::find(std::next(it), lessons.end(), currentLesson);
     }
 
+    CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
     return false;
 }
 
-bool ScheduleChromosomes::GroupsOrProfessorsIntersects(const ScheduleData& data,
-                                                       std::size_t currentRequest,
-                                                       std::size_t currentLesson) const
+template<typename Calendar>
+bool BasicScheduleChromosomes<Calendar>::GroupsOrProfessorsIntersects(const ScheduleData& data,
+                                                                      std::size_t currentRequest,
+                                                                      std::size_t currentLesson) const
 {
-    const auto& requests = data.SubjectRequests();
-    const auto& thisRequest = requests.at(currentRequest);
-    auto it = std::find(lessons_.begin(), lessons_.end(), currentLesson);
-    while(it != lessons_.end())
+    const auto& lessons = Lessons();
+    std::size_t checkedRequests = 0;
+    auto it = std::find(lessons.begin(), lessons.end(), currentLesson);
+    while(it != lessons.end())
     {
-        const std::size_t requestIndex = std::distance(lessons_.begin(), it);
-        const auto& otherRequest = requests.at(requestIndex);
-        if(thisRequest.Professor() == otherRequest.Professor() || set_intersects(thisRequest.Groups(), otherRequest.Groups()))
+        ++checkedRequests;
+        const std::size_t requestIndex = std::distance(lessons.begin(), it);
+        if(data.RequestsConflicts(currentRequest, requestIndex))
+        {
+            CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
             return true;
+        }
 
-        it = std::find(std::next(it), lessons_.end(), currentLesson);
+        it = std::find(std::next(it), lessons.end(), currentLesson);
     }
 
+    CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
     return false;
 }
 
-bool ScheduleChromosomes::ClassroomsIntersects(std::size_t currentLesson,
-                                               const ClassroomAddress& currentClassroom) const
+template<typename Calendar>
+bool BasicScheduleChromosomes<Calendar>::ClassroomsIntersects(std::size_t currentLesson,
+                                                              const ClassroomAddress& currentClassroom) const
 {
     if(currentClassroom == ClassroomAddress::Any())
         return false;
 
-    auto it = std::find(classrooms_.begin(), classrooms_.end(), currentClassroom);
-    while(it != classrooms_.end())
+    const auto& classrooms = Classrooms();
+    std::size_t checkedRequests = 0;
+    auto it = std::find(classrooms.begin(), classrooms.end(), currentClassroom);
+    while(it != classrooms.end())
     {
-        const std::size_t requestIndex = std::distance(classrooms_.begin(), it);
-        const std::size_t otherLesson = lessons_.at(requestIndex);
+        ++checkedRequests;
+        const std::size_t requestIndex = std::distance(classrooms.begin(), it);
+        const std::size_t otherLesson = Lesson(requestIndex);
         if(currentLesson == otherLesson)
+        {
+            CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
             return true;
+        }
 
-        it = std::find(std::next(it), classrooms_.end(), currentClassroom);
+        it = std::find(std::next(it), classrooms.end(), currentClassroom);
     }
 
+    CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, checkedRequests);
     return false;
 }
 
-bool ReadyToCrossover(const ScheduleChromosomes& first,
-                      const ScheduleChromosomes& second,
-                      const ScheduleData& data,
+template<typename Calendar>
+LessonsMask BasicScheduleChromosomes<Calendar>::FreeLessons(const ScheduleData& data,
+                                                            std::size_t currentRequest) const
+{
+    LessonsMask freeLessons = data.RequestedLessons(currentRequest);
+    const auto& lessons = Lessons();
+    const auto& classrooms = Classrooms();
+    const ClassroomAddress currentClassroom = classrooms.at(currentRequest);
+    const bool checkClassrooms = currentClassroom != ClassroomAddress::Any();
+    for(std::size_t r = 0; r < lessons.size(); ++r)
+    {
+        const std::size_t otherLesson = lessons[r];
+        if(otherLesson >= Calendar::MaxLessonsCount || !freeLessons.Test(otherLesson))
+            continue;
+
+        if(data.RequestsConflicts(currentRequest, r) || (checkClassrooms && classrooms[r] == currentClassroom))
+            freeLessons.Reset(otherLesson);
+    }
+
+    CountScheduleEvent(ScheduleCounter::ConflictCheckIterations, lessons.size());
+    return freeLessons;
+}
+
+template<typename Calendar>
+bool ReadyToCrossover(const BasicScheduleChromosomes<Calendar>& first,
+                      const BasicScheduleChromosomes<Calendar>& second,
+                      const BasicScheduleData<Calendar>& data,
                       std::size_t r)
 {
     const auto firstLesson = first.Lesson(r);
@@ -178,8 +361,9 @@ bool ReadyToCrossover(const ScheduleChromosomes& first,
     return true;
 }
 
-void Crossover(ScheduleChromosomes& first,
-               ScheduleChromosomes& second,
+template<typename Calendar>
+void Crossover(BasicScheduleChromosomes<Calendar>& first,
+               BasicScheduleChromosomes<Calendar>& second,
                std::size_t r)
 {
     using std::swap;
@@ -187,79 +371,573 @@ void Crossover(ScheduleChromosomes& first,
     swap(first.Classroom(r), second.Classroom(r));
 }
 
-std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
-                     const ScheduleData& scheduleData)
+template<typename Calendar>
+static bool NotPlaced(const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t r)
 {
-    std::size_t maxBuildingsDayEval = 0;
-    std::size_t maxDayComplexity = 0;
-    std::size_t maxLessonsGapsForGroupsSum = 0;
-    std::size_t maxLessonsGapsForProfessorsSum = 0;
+    return chromosomes.Lesson(r) == NO_LESSON || chromosomes.Classroom(r) == ClassroomAddress::NoClassroom();
+}
+
+// puts request r, which must be removed from the schedule, into the lesson if it is free of conflicts and has a free classroom
+template<typename Calendar>
+static bool TryPlaceAt(BasicScheduleChromosomes<Calendar>& chromosomes,
+                       const BasicScheduleData<Calendar>& data,
+                       std::size_t r,
+                       std::size_t lesson)
+{
+    if(chromosomes.GroupsOrProfessorsIntersects(data, r, lesson))
+        return false;
+
+    const auto& requestClassrooms = data.SubjectRequests()[r].Classrooms();
+    if(requestClassrooms.empty())
+    {
+        chromosomes.Lesson(r) = lesson;
+        chromosomes.Classroom(r) = ClassroomAddress::Any();
+        return true;
+    }
+
+    for(auto&& classroom : requestClassrooms)
+    {
+        if(!chromosomes.ClassroomsIntersects(lesson, classroom))
+        {
+            chromosomes.Lesson(r) = lesson;
+            chromosomes.Classroom(r) = classroom;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename Calendar>
+static bool TryPlace(BasicScheduleChromosomes<Calendar>& chromosomes,
+                     const BasicScheduleData<Calendar>& data,
+                     std::size_t r)
+{
+    const LessonsMask& requestedLessons = data.RequestedLessons(r);
+    for(std::size_t lesson = 0; lesson < Calendar::MaxLessonsCount; ++lesson)
+    {
+        if(requestedLessons.Test(lesson) && TryPlaceAt(chromosomes, data, r, lesson))
+            return true;
+    }
+
+    return false;
+}
+
+template<typename Calendar>
+static void RemoveFromSchedule(BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t r)
+{
+    chromosomes.Lesson(r) = NO_LESSON;
+    chromosomes.Classroom(r) = ClassroomAddress::NoClassroom();
+}
+
+// places removed request r into a lesson blocked by a single request which is moved to another place
+template<typename Calendar>
+static bool TryPlaceWithEjection(BasicScheduleChromosomes<Calendar>& chromosomes,
+                                 const BasicScheduleData<Calendar>& data,
+                                 std::size_t r)
+{
+    // genes are read through const chromosomes, so that copies sharing them are cloned only by an actual move
+    const BasicScheduleChromosomes<Calendar>& current = chromosomes;
+    const auto& requestClassrooms = data.SubjectRequests()[r].Classrooms();
+    const LessonsMask& requestedLessons = data.RequestedLessons(r);
+    std::vector<std::size_t> blocking;
+    for(std::size_t lesson = 0; lesson < Calendar::MaxLessonsCount; ++lesson)
+    {
+        if(!requestedLessons.Test(lesson))
+            continue;
+
+        // requests conflicting by groups or professors must all leave the lesson,
+        // without them any request taking one of the classrooms may leave instead
+        blocking.clear();
+        for(std::size_t other = 0; other < chromosomes.Lessons().size(); ++other)
+        {
+            if(current.Lesson(other) == lesson && data.RequestsConflicts(r, other))
+                blocking.emplace_back(other);
+        }
+
+        if(blocking.size() > 1)
+            continue;
+
+        if(blocking.empty())
+        {
+            for(std::size_t other = 0; other < chromosomes.Lessons().size(); ++other)
+            {
+                if(current.Lesson(other) == lesson && std::ranges::find(requestClassrooms, current.Classroom(other)) != requestClassrooms.end())
+                    blocking.emplace_back(other);
+            }
+        }
+
+        for(std::size_t ejected : blocking)
+        {
+            if(data.RequestHasLockedLesson(ejected))
+                continue;
+
+            const std::size_t ejectedLesson = current.Lesson(ejected);
+            const ClassroomAddress ejectedClassroom = current.Classroom(ejected);
+            RemoveFromSchedule(chromosomes, ejected);
+            if(TryPlaceAt(chromosomes, data, r, lesson))
+            {
+                if(TryPlace(chromosomes, data, ejected))
+                    return true;
+
+                RemoveFromSchedule(chromosomes, r);
+            }
+
+            chromosomes.Lesson(ejected) = ejectedLesson;
+            chromosomes.Classroom(ejected) = ejectedClassroom;
+        }
+    }
+
+    return false;
+}
+
+template<typename Calendar>
+std::size_t Repair(BasicScheduleChromosomes<Calendar>& chromosomes,
+                   const BasicScheduleData<Calendar>& data)
+{
+    std::size_t repaired = 0;
+    for(std::size_t r = 0; r < chromosomes.Lessons().size(); ++r)
+    {
+        if(!NotPlaced(chromosomes, r))
+            continue;
+
+        // locked request may only get a classroom in its lesson
+        if(data.RequestHasLockedLesson(r))
+        {
+            const auto& requestClassrooms = data.SubjectRequests()[r].Classrooms();
+            if(requestClassrooms.empty())
+            {
+                chromosomes.Classroom(r) = ClassroomAddress::Any();
+                ++repaired;
+            }
+
+            for(auto&& classroom : requestClassrooms)
+            {
+                if(!chromosomes.ClassroomsIntersects(std::as_const(chromosomes).Lesson(r), classroom))
+                {
+                    chromosomes.Classroom(r) = classroom;
+                    ++repaired;
+                    break;
+                }
+            }
+
+            continue;
+        }
 
-    auto toLesson = [&](std::size_t r){ return scheduleChromosomes.Lesson(r); };
-    auto inSameDay = [](std::size_t lhs, std::size_t rhs) { return lhs / MAX_LESSONS_PER_DAY == rhs / MAX_LESSONS_PER_DAY; };
+        const std::size_t oldLesson = chromosomes.Lesson(r);
+        const ClassroomAddress oldClassroom = chromosomes.Classroom(r);
+        RemoveFromSchedule(chromosomes, r);
+        if(TryPlace(chromosomes, data, r) || TryPlaceWithEjection(chromosomes, data, r))
+        {
+            ++repaired;
+        }
+        else
+        {
+            chromosomes.Lesson(r) = oldLesson;
+            chromosomes.Classroom(r) = oldClassroom;
+        }
+    }
+
+    return repaired;
+}
+
+// Lessons of a single day packed into bits, bit i is set if DayLesson i is occupied
+using DayLessonsMask = std::uint32_t;
+
+// distance between the first and the last lesson of the day, equals sum of gaps between consecutive lessons
+static std::size_t DayLessonsSpan(DayLessonsMask dayMask)
+{
+    assert(dayMask != 0);
+    return std::bit_width(dayMask) - 1 - std::countr_zero(dayMask);
+}
+
+static std::size_t BuildingsChanged(std::size_t lhsBuilding, std::size_t rhsBuilding)
+{
+    return !(lhsBuilding == NO_BUILDING || rhsBuilding == NO_BUILDING || lhsBuilding == rhsBuilding);
+}
+
+template<typename Calendar>
+static std::size_t EvaluateProfessorLessonsGaps(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                                const std::vector<std::size_t>& professorRequests)
+{
+    static_assert(Calendar::MaxLessonsPerDay <= std::numeric_limits<DayLessonsMask>::digits);
+
+    std::array<DayLessonsMask, Calendar::DaysInSchedule> dayMasks = {};
+    for(std::size_t r : professorRequests)
+    {
+        const std::size_t lesson = scheduleChromosomes.Lesson(r);
+        if(lesson != NO_LESSON)
+            dayMasks[Calendar::Day(lesson)] |= DayLessonsMask{1} << Calendar::DayLesson(lesson);
+    }
+
+    std::size_t maxLessonsGaps = 0;
+    for(DayLessonsMask dayMask : dayMasks)
+    {
+        if(dayMask != 0)
+            maxLessonsGaps = std::max(maxLessonsGaps, DayLessonsSpan(dayMask));
+    }
+
+    return maxLessonsGaps;
+}
+
+// Soft terms of Evaluate, kernels are instantiated for every combination of enabled terms
+enum ScheduleFitnessTerm : unsigned
+{
+    GROUPS_LESSONS_GAPS_TERM = 1,
+    PROFESSORS_LESSONS_GAPS_TERM = 2,
+    DAY_COMPLEXITY_TERM = 4,
+    BUILDINGS_CHANGES_TERM = 8,
+    GROUPS_TERMS = GROUPS_LESSONS_GAPS_TERM | DAY_COMPLEXITY_TERM | BUILDINGS_CHANGES_TERM,
+    ALL_TERMS = GROUPS_TERMS | PROFESSORS_LESSONS_GAPS_TERM
+};
+
+static constexpr unsigned EnabledTerms(const ScheduleFitnessWeights& weights)
+{
+    return (weights.GroupsLessonsGaps != 0 ? GROUPS_LESSONS_GAPS_TERM : 0u) |
+        (weights.ProfessorsLessonsGaps != 0 ? PROFESSORS_LESSONS_GAPS_TERM : 0u) |
+        (weights.DayComplexity != 0 ? DAY_COMPLEXITY_TERM : 0u) |
+        (weights.BuildingsChanges != 0 ? BUILDINGS_CHANGES_TERM : 0u);
+}
+
+// calls function.operator()<Terms>() with Terms equal to runtime terms
+template<unsigned Terms = 0, typename Function>
+static auto WithTerms(unsigned terms, Function&& function)
+{
+    if constexpr(Terms == ALL_TERMS)
+    {
+        assert(terms == ALL_TERMS);
+        return function.template operator()<Terms>();
+    }
+    else
+    {
+        if(terms == Terms)
+            return function.template operator()<Terms>();
+
+        return WithTerms<Terms + 1>(terms, std::forward<Function>(function));
+    }
+}
+
+template<typename FitnessPolicy, typename Function>
+static auto WithPolicyTerms(const FitnessPolicy& fitnessPolicy, Function&& function)
+{
+    if constexpr(FitnessPolicy::IsStatic)
+        return function.template operator()<EnabledTerms(FitnessPolicy::Weights())>();
+    else
+        return WithTerms(EnabledTerms(fitnessPolicy.Weights()), std::forward<Function>(function));
+}
+
+template<unsigned Terms, typename Calendar>
+static GroupEvaluation EvaluateGroup(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                     const BasicScheduleData<Calendar>& scheduleData,
+                                     const std::vector<std::size_t>& groupRequests)
+{
+    static_assert(Calendar::MaxLessonsPerDay <= std::numeric_limits<DayLessonsMask>::digits);
+    assert(std::ranges::is_sorted(groupRequests));
+
+    constexpr bool withGaps = (Terms & GROUPS_LESSONS_GAPS_TERM) != 0;
+    constexpr bool withComplexity = (Terms & DAY_COMPLEXITY_TERM) != 0;
+    constexpr bool withBuildings = (Terms & BUILDINGS_CHANGES_TERM) != 0;
 
     const auto& requests = scheduleData.SubjectRequests();
-    for(auto&&[professor, professorRequests] : scheduleData.Professors())
+    std::array<DayLessonsMask, Calendar::DaysInSchedule> dayMasks = {};
+    std::array<std::size_t, Calendar::DaysInSchedule> dayComplexity = {};
+
+    // requests sharing a lesson are visited in order of their indices,
+    // so first and last buildings and changes inside a lesson are counted as in a sorted lessons list;
+    // these arrays are written on the first occupation of a lesson before being read
+    std::array<std::size_t, Calendar::MaxLessonsCount> firstBuilding;
+    std::array<std::size_t, Calendar::MaxLessonsCount> lastBuilding;
+    std::array<std::size_t, Calendar::MaxLessonsCount> lessonBuildingsChanges;
+
+    for(std::size_t r : groupRequests)
     {
-        std::vector<std::size_t> lessons = professorRequests
-            | ranges::view::transform(toLesson)
-            | ranges::to<std::vector<std::size_t>>
-            | ranges::action::sort;
+        const std::size_t lesson = scheduleChromosomes.Lesson(r);
+        if(lesson == NO_LESSON)
+            continue;
+
+        const std::size_t day = Calendar::Day(lesson);
+        const DayLessonsMask lessonBit = DayLessonsMask{1} << Calendar::DayLesson(lesson);
+
+        if constexpr(withComplexity)
+            dayComplexity[day] += Calendar::DayLesson(lesson) * requests[r].Complexity();
 
-        for(auto day : lessons | ranges::view::group_by(inSameDay) | ranges::view::common)
+        if constexpr(withBuildings)
         {
-            maxLessonsGapsForProfessorsSum = std::max(maxLessonsGapsForProfessorsSum,
-                                                      std::inner_product(std::next(day.begin()), day.end(), day.begin(),
-                                                                         std::size_t{0}, std::plus<>{}, std::minus<>{}));
+            const std::size_t building = scheduleChromosomes.Classroom(r).Building;
+            if((dayMasks[day] & lessonBit) == 0)
+            {
+                firstBuilding[lesson] = building;
+                lastBuilding[lesson] = building;
+                lessonBuildingsChanges[lesson] = 0;
+            }
+            else
+            {
+                lessonBuildingsChanges[lesson] += BuildingsChanged(lastBuilding[lesson], building);
+                lastBuilding[lesson] = building;
+            }
         }
+
+        dayMasks[day] |= lessonBit;
     }
 
-    for(auto&&[group, groupRequests] : scheduleData.Groups())
+    GroupEvaluation result;
+    for(std::size_t day = 0; day < Calendar::DaysInSchedule; ++day)
     {
-        std::vector<std::pair<std::size_t, std::size_t>> lessons = ranges::view::zip(groupRequests | ranges::view::transform(toLesson), 
-                                                                                     groupRequests)
-            | ranges::to<std::vector<std::pair<std::size_t, std::size_t>>>
-            | ranges::action::sort;
+        DayLessonsMask dayMask = dayMasks[day];
+        if(dayMask == 0)
+            continue;
+
+        if constexpr(withComplexity)
+            result.DayComplexity = std::max(result.DayComplexity, dayComplexity[day]);
 
-        for(auto day : lessons
-            | ranges::view::filter([](auto&& item){ return item.first != NO_LESSON; })
-            | ranges::view::group_by([](auto&& lhs, auto&& rhs) { return lhs.first / MAX_LESSONS_PER_DAY == rhs.first / MAX_LESSONS_PER_DAY; })
-            | ranges::view::common)
+        if constexpr(withGaps)
+            result.LessonsGaps = std::max(result.LessonsGaps, DayLessonsSpan(dayMask));
+
+        if constexpr(withBuildings)
         {
-            maxDayComplexity = std::max(maxDayComplexity,
-                                        std::inner_product(day.begin(), day.end(), day.begin(),
-                                                           std::size_t{0},
-                                                           std::plus<>{},
-                                                           [&](auto&& lhs, auto&& rhs){ return lhs.first % MAX_LESSONS_PER_DAY * requests.at(rhs.second).Complexity(); }));
-
-            maxLessonsGapsForGroupsSum = std::max(maxLessonsGapsForGroupsSum,
-                                                  std::inner_product(std::next(day.begin()), day.end(), day.begin(),
-                                                                     std::size_t{0},
-                                                                     std::plus<>{},
-                                                                     [](auto&& lhs, auto&& rhs){ return lhs.first - rhs.first; }));
-
-            maxBuildingsDayEval = std::max(maxBuildingsDayEval,
-                                            std::inner_product(std::next(day.begin()), day.end(), day.begin(),
-                                                                std::size_t{0},
-                                                                std::plus<>{},
-                                                                [&](auto&& lhs, auto&& rhs) -> std::size_t
-            { 
-                const std::size_t lhsBuilding = scheduleChromosomes.Classroom(lhs.second).Building;
-                const std::size_t rhsBuilding = scheduleChromosomes.Classroom(rhs.second).Building;
-                return !(lhsBuilding == NO_BUILDING || rhsBuilding == NO_BUILDING || lhsBuilding == rhsBuilding);
-            }));
+            std::size_t buildingsChanges = 0;
+            std::size_t previousLesson = NO_LESSON;
+            for(; dayMask != 0; dayMask &= dayMask - 1)
+            {
+                const std::size_t lesson = day * Calendar::MaxLessonsPerDay + std::countr_zero(dayMask);
+                buildingsChanges += lessonBuildingsChanges[lesson];
+                if(previousLesson != NO_LESSON)
+                    buildingsChanges += BuildingsChanged(lastBuilding[previousLesson], firstBuilding[lesson]);
+
+                previousLesson = lesson;
+            }
+
+            result.BuildingsChanges = std::max(result.BuildingsChanges, buildingsChanges);
         }
     }
 
-    const std::size_t notPlacedLessons = std::ranges::count_if(scheduleChromosomes.Lessons(), 
-                                                               [](std::size_t lesson){ return lesson == NO_LESSON; });
+    return result;
+}
 
-    const std::size_t notPlacedClassrooms = std::ranges::count_if(scheduleChromosomes.Classrooms(), 
-                                                                  [](const ClassroomAddress& classroom){ return classroom == ClassroomAddress::NoClassroom(); });
+static std::size_t CombineEvaluation(const ScheduleFitnessWeights& weights,
+                                     std::size_t maxLessonsGapsForGroupsSum,
+                                     std::size_t maxLessonsGapsForProfessorsSum,
+                                     std::size_t maxDayComplexity,
+                                     std::size_t maxBuildingsDayEval,
+                                     std::size_t notPlacedLessons,
+                                     std::size_t notPlacedClassrooms)
+{
+    return maxLessonsGapsForGroupsSum * weights.GroupsLessonsGaps +
+        maxLessonsGapsForProfessorsSum * weights.ProfessorsLessonsGaps +
+        maxDayComplexity * weights.DayComplexity +
+        maxBuildingsDayEval * weights.BuildingsChanges +
+        notPlacedLessons * weights.NotPlacedLessons + notPlacedClassrooms * weights.NotPlacedClassrooms;
+}
 
-    return maxLessonsGapsForGroupsSum * 3 + 
-        maxLessonsGapsForProfessorsSum * 2 + 
-        maxDayComplexity * 4 + 
-        maxBuildingsDayEval * 64 +
-        notPlacedLessons * 100 + notPlacedClassrooms * 100;
+// keeps maximal term, the offender is tracked only by the detailed evaluation
+template<bool WithOffenders>
+static void UpdateWorst(std::size_t& worst, std::size_t& offender, std::size_t value, std::size_t index)
+{
+    if constexpr(WithOffenders)
+    {
+        if(value > worst)
+        {
+            worst = value;
+            offender = index;
+        }
+    }
+    else
+    {
+        worst = std::max(worst, value);
+    }
+}
+
+// offenders of the result are dense indexes of professors and groups
+template<unsigned Terms, bool WithOffenders, typename Calendar>
+static ScheduleEvaluation EvaluateTerms(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                        const BasicScheduleData<Calendar>& scheduleData,
+                                        const ScheduleFitnessWeights& weights)
+{
+    ScheduleEvaluation result;
+    if constexpr((Terms & PROFESSORS_LESSONS_GAPS_TERM) != 0)
+    {
+        const auto& professorsRequests = scheduleData.ProfessorsRequests();
+        for(std::size_t p = 0; p < professorsRequests.size(); ++p)
+        {
+            UpdateWorst<WithOffenders>(result.ProfessorsLessonsGaps, result.LessonsGapsProfessor,
+                                       EvaluateProfessorLessonsGaps(scheduleChromosomes, professorsRequests[p]), p);
+        }
+    }
+
+    if constexpr((Terms & GROUPS_TERMS) != 0)
+    {
+        const auto& groupsRequests = scheduleData.GroupsRequests();
+        for(std::size_t g = 0; g < groupsRequests.size(); ++g)
+        {
+            const GroupEvaluation group = EvaluateGroup<Terms>(scheduleChromosomes, scheduleData, groupsRequests[g]);
+            UpdateWorst<WithOffenders>(result.GroupsLessonsGaps, result.LessonsGapsGroup, group.LessonsGaps, g);
+            UpdateWorst<WithOffenders>(result.DayComplexity, result.DayComplexityGroup, group.DayComplexity, g);
+            UpdateWorst<WithOffenders>(result.BuildingsChanges, result.BuildingsChangesGroup, group.BuildingsChanges, g);
+        }
+    }
+
+    result.NotPlacedLessons = std::ranges::count_if(scheduleChromosomes.Lessons(), 
+                                                    [](std::size_t lesson){ return lesson == NO_LESSON; });
+
+    result.NotPlacedClassrooms = std::ranges::count_if(scheduleChromosomes.Classrooms(), 
+                                                       [](const ClassroomAddress& classroom){ return classroom == ClassroomAddress::NoClassroom(); });
+
+    result.Fitness = CombineEvaluation(weights,
+                                       result.GroupsLessonsGaps,
+                                       result.ProfessorsLessonsGaps,
+                                       result.DayComplexity,
+                                       result.BuildingsChanges,
+                                       result.NotPlacedLessons,
+                                       result.NotPlacedClassrooms);
+    return result;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+std::size_t Evaluate(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                     const BasicScheduleData<Calendar>& scheduleData,
+                     const FitnessPolicy& fitnessPolicy)
+{
+    return WithPolicyTerms(fitnessPolicy, [&]<unsigned Terms>()
+    {
+        return EvaluateTerms<Terms, false>(scheduleChromosomes, scheduleData, fitnessPolicy.Weights()).Fitness;
+    });
+}
+
+template<typename Calendar, typename FitnessPolicy>
+ScheduleEvaluation EvaluateDetailed(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                    const BasicScheduleData<Calendar>& scheduleData,
+                                    const FitnessPolicy& fitnessPolicy)
+{
+    ScheduleEvaluation result = WithPolicyTerms(fitnessPolicy, [&]<unsigned Terms>()
+    {
+        return EvaluateTerms<Terms, true>(scheduleChromosomes, scheduleData, fitnessPolicy.Weights());
+    });
+
+    auto toID = [](std::size_t& offender, auto&& id)
+    {
+        if(offender != NO_OFFENDER)
+            offender = id(offender);
+    };
+
+    toID(result.LessonsGapsProfessor, [&](std::size_t p) { return scheduleData.ProfessorID(p); });
+    toID(result.LessonsGapsGroup, [&](std::size_t g) { return scheduleData.GroupID(g); });
+    toID(result.DayComplexityGroup, [&](std::size_t g) { return scheduleData.GroupID(g); });
+    toID(result.BuildingsChangesGroup, [&](std::size_t g) { return scheduleData.GroupID(g); });
+    return result;
+}
+
+template<typename Calendar>
+std::size_t EvaluationScratchMemoryUsage(const BasicScheduleData<Calendar>&)
+{
+    // kernels keep per-day masks and per-lesson buildings on the stack and never allocate
+    return 3 * sizeof(std::array<std::size_t, Calendar::MaxLessonsCount>) +
+        sizeof(std::array<std::size_t, Calendar::DaysInSchedule>) +
+        sizeof(std::array<DayLessonsMask, Calendar::DaysInSchedule>);
+}
+
+
+template<typename Calendar, typename FitnessPolicy>
+IncrementalEvaluator<Calendar, FitnessPolicy>::IncrementalEvaluator(const ScheduleChromosomes& scheduleChromosomes,
+                                                                    const ScheduleData& scheduleData,
+                                                                    const FitnessPolicy& fitnessPolicy)
+    : pData_(&scheduleData)
+    , fitnessPolicy_(fitnessPolicy)
+    , professorsLessonsGaps_(scheduleData.ProfessorsRequests().size())
+    , groups_(scheduleData.GroupsRequests().size())
+    , notPlacedLessons_(std::ranges::count(scheduleChromosomes.Lessons(), NO_LESSON))
+    , notPlacedClassrooms_(std::ranges::count(scheduleChromosomes.Classrooms(), ClassroomAddress::NoClassroom()))
+{
+    WithPolicyTerms(fitnessPolicy_, [&]<unsigned Terms>()
+    {
+        const auto& professorsRequests = scheduleData.ProfessorsRequests();
+        if constexpr((Terms & PROFESSORS_LESSONS_GAPS_TERM) != 0)
+        {
+            for(std::size_t p = 0; p < professorsRequests.size(); ++p)
+                professorsLessonsGaps_[p] = EvaluateProfessorLessonsGaps(scheduleChromosomes, professorsRequests[p]);
+        }
+
+        const auto& groupsRequests = scheduleData.GroupsRequests();
+        if constexpr((Terms & GROUPS_TERMS) != 0)
+        {
+            for(std::size_t g = 0; g < groupsRequests.size(); ++g)
+                groups_[g] = EvaluateGroup<Terms>(scheduleChromosomes, scheduleData, groupsRequests[g]);
+        }
+    });
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void IncrementalEvaluator<Calendar, FitnessPolicy>::Update(const ScheduleChromosomes& scheduleChromosomes,
+                                                           std::size_t r,
+                                                           std::size_t oldLesson,
+                                                           const ClassroomAddress& oldClassroom)
+{
+    notPlacedLessons_ += (scheduleChromosomes.Lesson(r) == NO_LESSON);
+    notPlacedLessons_ -= (oldLesson == NO_LESSON);
+    notPlacedClassrooms_ += (scheduleChromosomes.Classroom(r) == ClassroomAddress::NoClassroom());
+    notPlacedClassrooms_ -= (oldClassroom == ClassroomAddress::NoClassroom());
+
+    WithPolicyTerms(fitnessPolicy_, [&]<unsigned Terms>()
+    {
+        if constexpr((Terms & PROFESSORS_LESSONS_GAPS_TERM) != 0)
+        {
+            const std::size_t p = pData_->RequestProfessorIndex(r);
+            professorsLessonsGaps_[p] = EvaluateProfessorLessonsGaps(scheduleChromosomes, pData_->ProfessorsRequests()[p]);
+        }
+
+        if constexpr((Terms & GROUPS_TERMS) != 0)
+        {
+            for(std::size_t g : pData_->RequestGroupsIndices(r))
+                groups_[g] = EvaluateGroup<Terms>(scheduleChromosomes, *pData_, pData_->GroupsRequests()[g]);
+        }
+    });
 }
+
+template<typename Calendar, typename FitnessPolicy>
+std::size_t IncrementalEvaluator<Calendar, FitnessPolicy>::Value() const
+{
+    std::size_t maxBuildingsDayEval = 0;
+    std::size_t maxDayComplexity = 0;
+    std::size_t maxLessonsGapsForGroupsSum = 0;
+    std::size_t maxLessonsGapsForProfessorsSum = 0;
+
+    for(std::size_t professorLessonsGaps : professorsLessonsGaps_)
+        maxLessonsGapsForProfessorsSum = std::max(maxLessonsGapsForProfessorsSum, professorLessonsGaps);
+
+    for(auto&& group : groups_)
+    {
+        maxLessonsGapsForGroupsSum = std::max(maxLessonsGapsForGroupsSum, group.LessonsGaps);
+        maxDayComplexity = std::max(maxDayComplexity, group.DayComplexity);
+        maxBuildingsDayEval = std::max(maxBuildingsDayEval, group.BuildingsChanges);
+    }
+
+    return CombineEvaluation(fitnessPolicy_.Weights(),
+                             maxLessonsGapsForGroupsSum,
+                             maxLessonsGapsForProfessorsSum,
+                             maxDayComplexity,
+                             maxBuildingsDayEval,
+                             notPlacedLessons_,
+                             notPlacedClassrooms_);
+}
+
+#define INSTANTIATE_SCHEDULE_FITNESS(Calendar, FitnessPolicy) \
+    template class IncrementalEvaluator<Calendar, FitnessPolicy>; \
+    template std::size_t Evaluate(const BasicScheduleChromosomes<Calendar>&, const BasicScheduleData<Calendar>&, \
+                                  const FitnessPolicy&); \
+    template ScheduleEvaluation EvaluateDetailed(const BasicScheduleChromosomes<Calendar>&, const BasicScheduleData<Calendar>&, \
+                                                 const FitnessPolicy&);
+
+#define INSTANTIATE_SCHEDULE_CHROMOSOMES(Calendar) \
+    template class BasicScheduleChromosomes<Calendar>; \
+    template bool ReadyToCrossover(const BasicScheduleChromosomes<Calendar>&, const BasicScheduleChromosomes<Calendar>&, \
+                                   const BasicScheduleData<Calendar>&, std::size_t); \
+    template void Crossover(BasicScheduleChromosomes<Calendar>&, BasicScheduleChromosomes<Calendar>&, std::size_t); \
+    template std::size_t EvaluationScratchMemoryUsage(const BasicScheduleData<Calendar>&); \
+    template std::size_t Repair(BasicScheduleChromosomes<Calendar>&, const BasicScheduleData<Calendar>&); \
+    INSTANTIATE_SCHEDULE_FITNESS(Calendar, DefaultFitnessPolicy) \
+    INSTANTIATE_SCHEDULE_FITNESS(Calendar, RuntimeFitnessPolicy)
+
+INSTANTIATE_SCHEDULE_CHROMOSOMES(DefaultScheduleCalendar)
+INSTANTIATE_SCHEDULE_CHROMOSOMES(EightLessonsScheduleCalendar)
+INSTANTIATE_SCHEDULE_CHROMOSOMES(OneWeekScheduleCalendar)
+
+INSTANTIATE_SCHEDULE_FITNESS(DefaultScheduleCalendar, NoBuildingsFitnessPolicy)
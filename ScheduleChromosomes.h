@@ -1,29 +1,86 @@
 #pragma once
 #include "ScheduleCommon.h"
+#include "ScheduleFitness.h"
+#include "ScheduleCounters.h"
 #include "LinearAllocator.h"
 
 #include <vector>
 #include <random>
 #include <tuple>
+#include <atomic>
+#include <memory>
 
 
-class ScheduleChromosomes
+// Value shared between copies until one of them is changed: the first non-const access of a shared copy clones it.
+// Moved-from objects keep sharing the value, so they stay valid.
+template<typename T>
+class CopyOnWrite
 {
 public:
+    explicit CopyOnWrite(T value)
+        : pValue_(std::make_shared<T>(std::move(value)))
+    { }
+
+    CopyOnWrite(const CopyOnWrite&) = default;
+    CopyOnWrite& operator=(const CopyOnWrite&) = default;
+
+    const T& Get() const { return *pValue_; }
+
+    T& Mutable()
+    {
+        if(pValue_.use_count() > 1)
+        {
+            CountScheduleEvent(ScheduleCounter::GenesCopies);
+            pValue_ = std::make_shared<T>(*pValue_);
+        }
+        else
+        {
+            // copies which stopped sharing the value on other threads have finished reading it
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+
+        return *pValue_;
+    }
+
+    bool Shared() const { return pValue_.use_count() > 1; }
+
+private:
+    std::shared_ptr<T> pValue_;
+};
+
+
+
+template<typename Calendar>
+class BasicScheduleChromosomes
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+
     // for testing
-    explicit ScheduleChromosomes(std::vector<std::size_t> lessons,
-                                 std::vector<ClassroomAddress> classrooms);
+    explicit BasicScheduleChromosomes(std::vector<std::size_t> lessons,
+                                      std::vector<ClassroomAddress> classrooms);
+
+    explicit BasicScheduleChromosomes(const ScheduleData& data);
+
+    // randomized DSatur coloring of the conflict graph: the request with the fewest lessons left free
+    // by already placed neighbours goes first, ties are broken by number of conflicts and then randomly;
+    // it takes the earliest lesson of a day with a free classroom, the day and the classroom are chosen randomly
+    explicit BasicScheduleChromosomes(const ScheduleData& data, std::mt19937& randGen);
 
-    explicit ScheduleChromosomes(const ScheduleData& data);
+    const std::vector<std::size_t>& Lessons() const { return lessons_.Get(); }
+    const std::vector<ClassroomAddress>& Classrooms() const { return classrooms_.Get(); }
 
-    const std::vector<std::size_t>& Lessons() const { return lessons_; }
-    const std::vector<ClassroomAddress>& Classrooms() const { return classrooms_; }
+    // copies share genes until the first non-const access
+    std::size_t Lesson(std::size_t r) const { return lessons_.Get().at(r); }
+    std::size_t& Lesson(std::size_t r) { return lessons_.Mutable().at(r); }
 
-    std::size_t Lesson(std::size_t r) const { return lessons_.at(r); }
-    std::size_t& Lesson(std::size_t r) { return lessons_.at(r); }
+    ClassroomAddress Classroom(std::size_t r) const { return classrooms_.Get().at(r); }
+    ClassroomAddress& Classroom(std::size_t r) { return classrooms_.Mutable().at(r); }
 
-    ClassroomAddress Classroom(std::size_t r) const { return classrooms_.at(r); }
-    ClassroomAddress& Classroom(std::size_t r) { return classrooms_.at(r); }
+    bool SharesGenes() const { return lessons_.Shared() || classrooms_.Shared(); }
+
+    // heap bytes of the genes, counted in full even if they are shared with other copies
+    std::size_t MemoryUsage() const { return HeapMemoryUsage(Lessons()) + HeapMemoryUsage(Classrooms()); }
 
     bool GroupsOrProfessorsOrClassroomsIntersects(const ScheduleData& data,
                                                   std::size_t currentRequest,
@@ -36,22 +93,114 @@ public:
     bool ClassroomsIntersects(std::size_t currentLesson,
                               const ClassroomAddress& currentClassroom) const;
 
+    // lessons requested by the request where it does not intersect other requests by groups, professors or classrooms
+    LessonsMask FreeLessons(const ScheduleData& data,
+                            std::size_t currentRequest) const;
+
 private:
+    void InitLockedLessons(const ScheduleData& data);
     void InitFromRequest(const ScheduleData& data, std::size_t requestIndex);
 
 private:
-    std::vector<std::size_t> lessons_;
-    std::vector<ClassroomAddress> classrooms_;
+    CopyOnWrite<std::vector<std::size_t>> lessons_;
+    CopyOnWrite<std::vector<ClassroomAddress>> classrooms_;
 };
 
-bool ReadyToCrossover(const ScheduleChromosomes& first,
-                      const ScheduleChromosomes& second,
-                      const ScheduleData& data,
+using ScheduleChromosomes = BasicScheduleChromosomes<DefaultScheduleCalendar>;
+
+template<typename Calendar>
+bool ReadyToCrossover(const BasicScheduleChromosomes<Calendar>& first,
+                      const BasicScheduleChromosomes<Calendar>& second,
+                      const BasicScheduleData<Calendar>& data,
                       std::size_t r);
 
-void Crossover(ScheduleChromosomes& first,
-               ScheduleChromosomes& second,
+template<typename Calendar>
+void Crossover(BasicScheduleChromosomes<Calendar>& first,
+               BasicScheduleChromosomes<Calendar>& second,
                std::size_t r);
 
-std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
-                     const ScheduleData& scheduleData);
+// places requests without a lesson or a classroom into a lesson and classroom free of conflicts;
+// if every requested lesson is blocked, tries lessons blocked by a single request and moves that request elsewhere
+// (ejection chain of length one), locked lessons are never moved; returns number of repaired requests
+template<typename Calendar>
+std::size_t Repair(BasicScheduleChromosomes<Calendar>& chromosomes,
+                   const BasicScheduleData<Calendar>& data);
+
+template<typename Calendar, typename FitnessPolicy = DefaultFitnessPolicy>
+std::size_t Evaluate(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                     const BasicScheduleData<Calendar>& scheduleData,
+                     const FitnessPolicy& fitnessPolicy = {});
+
+
+constexpr auto NO_OFFENDER = std::numeric_limits<std::size_t>::max();
+
+// Terms of Evaluate before weighting together with the professor or group giving each of them
+struct ScheduleEvaluation
+{
+    std::size_t GroupsLessonsGaps = 0;
+    std::size_t ProfessorsLessonsGaps = 0;
+    std::size_t DayComplexity = 0;
+    std::size_t BuildingsChanges = 0;
+    std::size_t NotPlacedLessons = 0;
+    std::size_t NotPlacedClassrooms = 0;
+    // weighted sum, same value as Evaluate()
+    std::size_t Fitness = 0;
+
+    // identifiers of the first group or professor with the maximal term, NO_OFFENDER if the term is zero or disabled
+    std::size_t LessonsGapsGroup = NO_OFFENDER;
+    std::size_t LessonsGapsProfessor = NO_OFFENDER;
+    std::size_t DayComplexityGroup = NO_OFFENDER;
+    std::size_t BuildingsChangesGroup = NO_OFFENDER;
+};
+
+// runs the same kernel as Evaluate, additionally tracking the worst professor and groups
+template<typename Calendar, typename FitnessPolicy = DefaultFitnessPolicy>
+ScheduleEvaluation EvaluateDetailed(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                    const BasicScheduleData<Calendar>& scheduleData,
+                                    const FitnessPolicy& fitnessPolicy = {});
+
+// peak bytes of temporary buffers used by a single Evaluate call
+template<typename Calendar>
+std::size_t EvaluationScratchMemoryUsage(const BasicScheduleData<Calendar>& scheduleData);
+
+
+struct GroupEvaluation
+{
+    std::size_t LessonsGaps = 0;
+    std::size_t DayComplexity = 0;
+    std::size_t BuildingsChanges = 0;
+};
+
+// Keeps per-professor and per-group terms of Evaluate,
+// so that after moving a single request only its professor and groups are rescored.
+template<typename Calendar, typename FitnessPolicy = DefaultFitnessPolicy>
+class IncrementalEvaluator
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+    using ScheduleChromosomes = BasicScheduleChromosomes<Calendar>;
+
+    explicit IncrementalEvaluator(const ScheduleChromosomes& scheduleChromosomes,
+                                  const ScheduleData& scheduleData,
+                                  const FitnessPolicy& fitnessPolicy = {});
+
+    // rescores terms affected by request r which was moved from oldLesson and oldClassroom
+    void Update(const ScheduleChromosomes& scheduleChromosomes,
+                std::size_t r,
+                std::size_t oldLesson,
+                const ClassroomAddress& oldClassroom);
+
+    // same value as Evaluate() for current chromosomes
+    std::size_t Value() const;
+
+    // bytes of the evaluator together with its per-professor and per-group terms
+    std::size_t MemoryUsage() const { return sizeof(*this) + HeapMemoryUsage(professorsLessonsGaps_) + HeapMemoryUsage(groups_); }
+
+private:
+    const ScheduleData* pData_;
+    [[no_unique_address]] FitnessPolicy fitnessPolicy_;
+    std::vector<std::size_t> professorsLessonsGaps_;
+    std::vector<GroupEvaluation> groups_;
+    std::size_t notPlacedLessons_;
+    std::size_t notPlacedClassrooms_;
+};
@@ -1,7 +1,9 @@
 #include "ScheduleCommon.h"
 
+#include <map>
 #include <string>
 #include <cassert>
+#include <numeric>
 #include <stdexcept>
 #include <algorithm>
 
@@ -19,9 +21,6 @@ SubjectRequest::SubjectRequest(std::size_t id,
     , groups_(std::move(groups))
     , classrooms_(std::move(classrooms))
 {
-    if(weekDays_.empty())
-        weekDays_.assign(weekDays.size(), true);
-
     std::ranges::sort(groups_);
     groups_.erase(std::unique(groups_.begin(), groups_.end()), groups_.end());
 
@@ -41,20 +40,126 @@ bool SubjectRequest::RequestedGroup(std::size_t g) const
     return it != groups_.end() && *it == g;
 }
 
-bool SubjectRequest::RequestedWeekDay(std::size_t d) const { return weekDays_.at(d % DAYS_IN_SCHEDULE_WEEK); }
+bool SubjectRequest::RequestedWeekDay(std::size_t weekDay) const { return weekDays_.empty() || (weekDay < weekDays_.size() && weekDays_[weekDay]); }
 const std::vector<std::size_t>& SubjectRequest::Groups() const { return groups_; }
 const std::vector<ClassroomAddress>& SubjectRequest::Classrooms() const { return classrooms_; }
 std::size_t SubjectRequest::ID() const { return id_; }
 std::size_t SubjectRequest::Complexity() const { return complexity_; }
 std::size_t SubjectRequest::Professor() const { return professor_; }
 
+std::size_t SubjectRequest::MemoryUsage() const
+{
+    return HeapMemoryUsage(weekDays_) + HeapMemoryUsage(groups_) + HeapMemoryUsage(classrooms_);
+}
+
+
+RequestsConflictGraph::RequestsConflictGraph(const std::vector<SubjectRequest>& requests)
+    : size_(requests.size())
+    , rowWords_(0)
+    , rows_()
+    , adjacency_(requests.size())
+{
+    std::unordered_map<std::size_t, std::vector<std::size_t>> professorRequests;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> groupRequests;
+    for(std::size_t r = 0; r < requests.size(); ++r)
+    {
+        professorRequests[requests[r].Professor()].emplace_back(r);
+        for(std::size_t g : requests[r].Groups())
+            groupRequests[g].emplace_back(r);
+    }
+
+    auto connectAll = [&](const std::vector<std::size_t>& clique)
+    {
+        for(std::size_t lhs : clique)
+        {
+            auto& neighbours = adjacency_[lhs];
+            neighbours.insert(neighbours.end(), clique.begin(), clique.end());
+        }
+    };
+
+    for(auto&& [professor, clique] : professorRequests)
+        connectAll(clique);
+
+    for(auto&& [group, clique] : groupRequests)
+        connectAll(clique);
+
+    for(auto& neighbours : adjacency_)
+    {
+        std::ranges::sort(neighbours);
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    if(size_ > DENSE_CONFLICT_GRAPH_MAX_SIZE)
+        return;
+
+    rowWords_ = (size_ + 63) / 64;
+    rows_.assign(size_ * rowWords_, 0);
+    for(std::size_t lhs = 0; lhs < size_; ++lhs)
+    {
+        for(std::size_t rhs : adjacency_[lhs])
+            rows_[lhs * rowWords_ + rhs / 64] |= std::uint64_t{1} << (rhs % 64);
+    }
+
+    adjacency_.clear();
+    adjacency_.shrink_to_fit();
+}
+
 
-ScheduleData::ScheduleData(std::vector<SubjectRequest> subjectRequests,
-                           std::vector<SubjectWithAddress> lockedLessons)
+// Union-find over request indices with path halving and union by size
+class DisjointSets
+{
+public:
+    explicit DisjointSets(std::size_t count)
+        : parents_(count)
+        , sizes_(count, 1)
+    {
+        std::iota(parents_.begin(), parents_.end(), std::size_t{0});
+    }
+
+    std::size_t Find(std::size_t x)
+    {
+        while(parents_[x] != x)
+        {
+            parents_[x] = parents_[parents_[x]];
+            x = parents_[x];
+        }
+
+        return x;
+    }
+
+    void Unite(std::size_t lhs, std::size_t rhs)
+    {
+        lhs = Find(lhs);
+        rhs = Find(rhs);
+        if(lhs == rhs)
+            return;
+
+        if(sizes_[lhs] < sizes_[rhs])
+            std::swap(lhs, rhs);
+
+        parents_[rhs] = lhs;
+        sizes_[lhs] += sizes_[rhs];
+    }
+
+private:
+    std::vector<std::size_t> parents_;
+    std::vector<std::size_t> sizes_;
+};
+
+
+template<typename Calendar>
+BasicScheduleData<Calendar>::BasicScheduleData(std::vector<SubjectRequest> subjectRequests,
+                                               std::vector<SubjectWithAddress> lockedLessons)
     : subjectRequests_(std::move(subjectRequests))
     , lockedLessons_(std::move(lockedLessons))
     , professorRequests_()
     , groupRequests_()
+    , conflictGraph_()
+    , requestsInfo_()
+    , professorsRequests_()
+    , groupsRequests_()
+    , requestsGroups_()
+    , components_()
 {
     std::ranges::sort(subjectRequests_, {}, &SubjectRequest::ID);
     subjectRequests_.erase(std::unique(subjectRequests_.begin(), subjectRequests_.end(),
@@ -63,6 +168,16 @@ ScheduleData::ScheduleData(std::vector<SubjectRequest> subjectRequests,
     std::ranges::sort(lockedLessons_, {}, &SubjectWithAddress::SubjectRequestID);
     lockedLessons_.erase(std::unique(lockedLessons_.begin(), lockedLessons_.end()), lockedLessons_.end());
 
+    // evaluation and initialization index per-lesson tables by locked lessons directly
+    for(const auto& lockedLesson : lockedLessons_)
+    {
+        if(lockedLesson.Address >= Calendar::MaxLessonsCount && lockedLesson.Address != std::numeric_limits<std::size_t>::max())
+        {
+            throw std::out_of_range("Locked lesson " + std::to_string(lockedLesson.Address) + " of subject request with ID=" +
+                                    std::to_string(lockedLesson.SubjectRequestID) + " is out of calendar");
+        }
+    }
+
     for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
     {
         const auto& request = subjectRequests_.at(r);
@@ -70,9 +185,121 @@ ScheduleData::ScheduleData(std::vector<SubjectRequest> subjectRequests,
         for(std::size_t g : request.Groups())
             groupRequests_[g].insert(r);
     }
+
+    conflictGraph_ = RequestsConflictGraph(subjectRequests_);
+
+    requestsInfo_.resize(subjectRequests_.size());
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        const auto& request = subjectRequests_[r];
+        auto& info = requestsInfo_[r];
+        for(std::size_t l = 0; l < Calendar::MaxLessonsCount; ++l)
+        {
+            if(request.RequestedWeekDay(Calendar::WeekDay(Calendar::Day(l))) && !Calendar::IsLateLessonInSaturday(l))
+                info.RequestedLessons.Set(l);
+        }
+
+        info.HasLockedLesson = SubjectRequestHasLockedLesson(request);
+    }
+
+    std::unordered_map<std::size_t, std::size_t> professorsIndices;
+    std::unordered_map<std::size_t, std::size_t> groupsIndices;
+    requestsGroups_.resize(subjectRequests_.size());
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        const auto& request = subjectRequests_[r];
+        const auto [professorIt, newProfessor] = professorsIndices.emplace(request.Professor(), professorsRequests_.size());
+        if(newProfessor)
+            professorsRequests_.emplace_back();
+
+        professorsRequests_[professorIt->second].emplace_back(r);
+        requestsInfo_[r].ProfessorIndex = professorIt->second;
+
+        for(std::size_t g : request.Groups())
+        {
+            const auto [groupIt, newGroup] = groupsIndices.emplace(g, groupsRequests_.size());
+            if(newGroup)
+                groupsRequests_.emplace_back();
+
+            groupsRequests_[groupIt->second].emplace_back(r);
+            requestsGroups_[r].emplace_back(groupIt->second);
+        }
+    }
+
+    DisjointSets requestsSets(subjectRequests_.size());
+    auto uniteAll = [&](const std::vector<std::size_t>& requests)
+    {
+        for(std::size_t r : requests)
+            requestsSets.Unite(requests.front(), r);
+    };
+
+    std::ranges::for_each(professorsRequests_, uniteAll);
+    std::ranges::for_each(groupsRequests_, uniteAll);
+
+    std::map<ClassroomAddress, std::size_t> classroomsRequests;
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        for(const auto& classroom : subjectRequests_[r].Classrooms())
+        {
+            // requests placed to any classroom never intersect by classrooms
+            if(classroom == ClassroomAddress::Any())
+                continue;
+
+            const auto [it, inserted] = classroomsRequests.emplace(classroom, r);
+            requestsSets.Unite(it->second, r);
+        }
+    }
+
+    std::unordered_map<std::size_t, std::size_t> componentsIndices;
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        const auto [it, inserted] = componentsIndices.emplace(requestsSets.Find(r), components_.size());
+        if(inserted)
+            components_.emplace_back();
+
+        components_[it->second].emplace_back(r);
+    }
 }
 
-const SubjectRequest& ScheduleData::SubjectRequestAtID(std::size_t subjectRequestID) const
+template<typename Calendar>
+std::size_t BasicScheduleData<Calendar>::MemoryUsage() const
+{
+    std::size_t result = sizeof(*this) + HeapMemoryUsage(subjectRequests_) + HeapMemoryUsage(lockedLessons_);
+    for(const auto& request : subjectRequests_)
+        result += request.MemoryUsage();
+
+    return result + HeapMemoryUsage(professorRequests_) +
+        HeapMemoryUsage(groupRequests_) +
+        conflictGraph_.MemoryUsage() +
+        HeapMemoryUsage(requestsInfo_) +
+        HeapMemoryUsage(professorsRequests_) +
+        HeapMemoryUsage(groupsRequests_) +
+        HeapMemoryUsage(requestsGroups_) +
+        HeapMemoryUsage(components_);
+}
+
+template<typename Calendar>
+BasicScheduleData<Calendar> BasicScheduleData<Calendar>::ComponentData(const std::vector<std::size_t>& requests) const
+{
+    assert(std::ranges::is_sorted(requests));
+
+    std::vector<SubjectRequest> componentRequests;
+    std::vector<SubjectWithAddress> componentLockedLessons;
+    componentRequests.reserve(requests.size());
+    for(std::size_t r : requests)
+    {
+        const auto& request = subjectRequests_.at(r);
+        componentRequests.emplace_back(request);
+
+        auto locked = std::ranges::equal_range(lockedLessons_, request.ID(), {}, &SubjectWithAddress::SubjectRequestID);
+        componentLockedLessons.insert(componentLockedLessons.end(), locked.begin(), locked.end());
+    }
+
+    return BasicScheduleData(std::move(componentRequests), std::move(componentLockedLessons));
+}
+
+template<typename Calendar>
+const SubjectRequest& BasicScheduleData<Calendar>::SubjectRequestAtID(std::size_t subjectRequestID) const
 {
     auto it = std::ranges::lower_bound(subjectRequests_, subjectRequestID, {}, &SubjectRequest::ID);
     if(it == subjectRequests_.end() || it->ID() != subjectRequestID)
@@ -81,7 +308,8 @@ const SubjectRequest& ScheduleData::SubjectRequestAtID(std::size_t subjectReques
     return *it;
 }
 
-std::size_t ScheduleData::IndexOfSubjectRequestWithID(std::size_t subjectRequestID) const
+template<typename Calendar>
+std::size_t BasicScheduleData<Calendar>::IndexOfSubjectRequestWithID(std::size_t subjectRequestID) const
 {
     auto it = std::ranges::lower_bound(subjectRequests_, subjectRequestID, {}, &SubjectRequest::ID);
     if(it == subjectRequests_.end() || it->ID() != subjectRequestID)
@@ -90,7 +318,22 @@ std::size_t ScheduleData::IndexOfSubjectRequestWithID(std::size_t subjectRequest
     return std::distance(subjectRequests_.begin(), it);
 }
 
-bool ScheduleData::SubjectRequestHasLockedLesson(const SubjectRequest& request) const
+template<typename Calendar>
+bool BasicScheduleData<Calendar>::SubjectRequestHasLockedLesson(const SubjectRequest& request) const
 {
     return std::ranges::binary_search(lockedLessons_, request.ID(), {}, &SubjectWithAddress::SubjectRequestID);
 }
+
+template<typename Calendar>
+std::size_t BasicScheduleData<Calendar>::GroupID(std::size_t g) const
+{
+    // groups of a request and their dense indexes are stored in the same order
+    const std::size_t r = groupsRequests_.at(g).front();
+    const auto position = std::ranges::find(requestsGroups_[r], g) - requestsGroups_[r].begin();
+    return subjectRequests_[r].Groups()[position];
+}
+
+
+template class BasicScheduleData<DefaultScheduleCalendar>;
+template class BasicScheduleData<EightLessonsScheduleCalendar>;
+template class BasicScheduleData<OneWeekScheduleCalendar>;
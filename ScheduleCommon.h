@@ -1,6 +1,8 @@
 #pragma once
 #include "utils.h"
 #include <limits>
+#include <cstdint>
+#include <bit>
 #include <vector>
 #include <array>
 #include <algorithm>
@@ -8,14 +10,137 @@
 #include <cassert>
 #include <unordered_map>
 #include <unordered_set>
+#include <type_traits>
 
 
-constexpr auto MAX_LESSONS_PER_DAY = 7;
-constexpr auto DAYS_IN_SCHEDULE_WEEK = 6;
-constexpr auto DAYS_IN_SCHEDULE = DAYS_IN_SCHEDULE_WEEK * 2;
-constexpr auto MAX_LESSONS_COUNT = MAX_LESSONS_PER_DAY * DAYS_IN_SCHEDULE_WEEK * 2;
 constexpr auto RECOMMENDED_LESSONS_COUNT = 3;
 constexpr auto NO_BUILDING = std::numeric_limits<std::size_t>::max();
+constexpr auto DENSE_CONFLICT_GRAPH_MAX_SIZE = 4096;
+constexpr auto SATURDAY = 5;
+
+
+// Heap bytes owned by containers, used for memory reports
+template<typename T>
+std::size_t HeapMemoryUsage(const std::vector<T>& values)
+{
+    if constexpr(std::is_same_v<T, bool>)
+        return (values.capacity() + 7) / 8;
+    else
+        return values.capacity() * sizeof(T);
+}
+
+template<typename T>
+std::size_t HeapMemoryUsage(const std::vector<std::vector<T>>& values)
+{
+    std::size_t result = values.capacity() * sizeof(std::vector<T>);
+    for(const auto& nested : values)
+        result += HeapMemoryUsage(nested);
+
+    return result;
+}
+
+// approximation for node based hash containers: bucket array plus one node (value, next pointer, cached hash) per element
+template<typename Key>
+std::size_t HeapMemoryUsage(const std::unordered_set<Key>& values)
+{
+    return values.bucket_count() * sizeof(void*) + values.size() * (sizeof(Key) + 2 * sizeof(void*));
+}
+
+template<typename Key, typename Value>
+std::size_t HeapMemoryUsage(const std::unordered_map<Key, std::unordered_set<Value>>& values)
+{
+    std::size_t result = values.bucket_count() * sizeof(void*) +
+        values.size() * (sizeof(std::pair<const Key, std::unordered_set<Value>>) + 2 * sizeof(void*));
+
+    for(const auto& [key, nested] : values)
+        result += HeapMemoryUsage(nested);
+
+    return result;
+}
+
+
+// Set of schedule lessons packed into 128 bits, one bit per lesson.
+class LessonsMask
+{
+public:
+    static constexpr std::size_t Capacity = 128;
+
+    constexpr void Set(std::size_t l) { words_[l / 64] |= std::uint64_t{1} << (l % 64); }
+    constexpr void Reset(std::size_t l) { words_[l / 64] &= ~(std::uint64_t{1} << (l % 64)); }
+    constexpr bool Test(std::size_t l) const { return (words_[l / 64] >> (l % 64)) & 1; }
+
+    constexpr std::size_t Count() const { return std::popcount(words_[0]) + std::popcount(words_[1]); }
+    constexpr bool None() const { return (words_[0] | words_[1]) == 0; }
+
+    // returns n-th (zero-based) lesson in the set, n must be less than Count()
+    constexpr std::size_t NthLesson(std::size_t n) const
+    {
+        assert(n < Count());
+        std::size_t word = 0;
+        if(const std::size_t lowCount = std::popcount(words_[0]); n >= lowCount)
+        {
+            word = 1;
+            n -= lowCount;
+        }
+
+        std::uint64_t bits = words_[word];
+        for(; n > 0; --n)
+            bits &= bits - 1;
+
+        return word * 64 + std::countr_zero(bits);
+    }
+
+    friend constexpr bool operator==(const LessonsMask& lhs, const LessonsMask& rhs) = default;
+
+private:
+    std::array<std::uint64_t, 2> words_ = {};
+};
+
+
+template<std::size_t LessonsPerDay, std::size_t DaysInWeek, std::size_t WeeksCount, std::size_t SaturdayLessonsCount>
+constexpr std::array<bool, LessonsPerDay * DaysInWeek * WeeksCount> MakeLateSaturdayLessonsTable()
+{
+    std::array<bool, LessonsPerDay * DaysInWeek * WeeksCount> table = {};
+    if constexpr(DaysInWeek > SATURDAY)
+    {
+        for(std::size_t week = 0; week < WeeksCount; ++week)
+        {
+            for(std::size_t dayLesson = SaturdayLessonsCount; dayLesson < LessonsPerDay; ++dayLesson)
+                table[(week * DaysInWeek + SATURDAY) * LessonsPerDay + dayLesson] = true;
+        }
+    }
+
+    return table;
+}
+
+// Compile-time shape of the schedule.
+// Only first SaturdayLessonsCount lessons of saturday may be scheduled.
+template<std::size_t LessonsPerDay, std::size_t DaysInWeek, std::size_t WeeksCount, std::size_t SaturdayLessonsCount>
+struct ScheduleCalendar
+{
+    static constexpr std::size_t MaxLessonsPerDay = LessonsPerDay;
+    static constexpr std::size_t DaysInScheduleWeek = DaysInWeek;
+    static constexpr std::size_t DaysInSchedule = DaysInWeek * WeeksCount;
+    static constexpr std::size_t MaxLessonsCount = LessonsPerDay * DaysInSchedule;
+    static constexpr auto LateSaturdayLessonsTable = MakeLateSaturdayLessonsTable<LessonsPerDay, DaysInWeek, WeeksCount, SaturdayLessonsCount>();
+
+    static_assert(MaxLessonsCount <= LessonsMask::Capacity, "schedule lessons must fit into LessonsMask");
+    static_assert(SaturdayLessonsCount <= LessonsPerDay, "saturday lessons count must not exceed lessons per day");
+
+    static constexpr std::size_t Day(std::size_t l) { return l / LessonsPerDay; }
+    static constexpr std::size_t DayLesson(std::size_t l) { return l % LessonsPerDay; }
+    static constexpr std::size_t WeekDay(std::size_t day) { return day % DaysInWeek; }
+    static constexpr bool IsLateLessonInSaturday(std::size_t l) { return LateSaturdayLessonsTable[l]; }
+};
+
+using DefaultScheduleCalendar = ScheduleCalendar<7, 6, 2, 4>;
+using EightLessonsScheduleCalendar = ScheduleCalendar<8, 6, 2, 4>;
+using OneWeekScheduleCalendar = ScheduleCalendar<7, 6, 1, 4>;
+
+constexpr auto MAX_LESSONS_PER_DAY = DefaultScheduleCalendar::MaxLessonsPerDay;
+constexpr auto DAYS_IN_SCHEDULE_WEEK = DefaultScheduleCalendar::DaysInScheduleWeek;
+constexpr auto DAYS_IN_SCHEDULE = DefaultScheduleCalendar::DaysInSchedule;
+constexpr auto MAX_LESSONS_COUNT = DefaultScheduleCalendar::MaxLessonsCount;
 
 
 struct ScheduleItem
@@ -81,7 +206,8 @@ public:
 
    bool RequestedClassroom(const ClassroomAddress& classroomAddress) const;
    bool RequestedGroup(std::size_t g) const;
-   bool RequestedWeekDay(std::size_t d) const;
+   // empty week days list means that every week day is requested
+   bool RequestedWeekDay(std::size_t weekDay) const;
 
    const std::vector<std::size_t>& Groups() const;
    const std::vector<ClassroomAddress>& Classrooms() const;
@@ -90,6 +216,9 @@ public:
    std::size_t Complexity() const;
    std::size_t Professor() const;
 
+   // heap bytes owned by the request
+   std::size_t MemoryUsage() const;
+
    friend bool operator==(const SubjectRequest& lhs, const SubjectRequest& rhs)
    {
        return lhs.professor_ == rhs.professor_ &&
@@ -144,12 +273,54 @@ struct SubjectWithAddress
 };
 
 
-class ScheduleData
+// Per-request data precomputed once for the mutation and initialization loops
+struct SubjectRequestStaticInfo
+{
+    LessonsMask RequestedLessons;
+    bool HasLockedLesson = false;
+    std::size_t ProfessorIndex = 0;
+};
+
+
+// Conflict graph over request indices: two requests are adjacent if they share a professor or any group.
+// Every request is adjacent to itself. Small graphs are stored as dense bitset rows, large ones as sorted adjacency lists.
+class RequestsConflictGraph
 {
 public:
-    ScheduleData() = default;
-    explicit ScheduleData(std::vector<SubjectRequest> subjectRequests,
-                          std::vector<SubjectWithAddress> lockedLessons);
+    RequestsConflictGraph() = default;
+    explicit RequestsConflictGraph(const std::vector<SubjectRequest>& requests);
+
+    std::size_t Size() const { return size_; }
+    bool IsDense() const { return !rows_.empty(); }
+
+    bool Adjacent(std::size_t lhs, std::size_t rhs) const
+    {
+        assert(lhs < size_ && rhs < size_);
+        if(IsDense())
+            return (rows_[lhs * rowWords_ + rhs / 64] >> (rhs % 64)) & 1;
+
+        return std::ranges::binary_search(adjacency_[lhs], rhs);
+    }
+
+    // heap bytes owned by the graph
+    std::size_t MemoryUsage() const { return HeapMemoryUsage(rows_) + HeapMemoryUsage(adjacency_); }
+
+private:
+    std::size_t size_ = 0;
+    std::size_t rowWords_ = 0;
+    std::vector<std::uint64_t> rows_;
+    std::vector<std::vector<std::size_t>> adjacency_;
+};
+
+
+template<typename Calendar>
+class BasicScheduleData
+{
+public:
+    BasicScheduleData() = default;
+    // throws std::out_of_range if a locked lesson is outside of the calendar
+    explicit BasicScheduleData(std::vector<SubjectRequest> subjectRequests,
+                               std::vector<SubjectWithAddress> lockedLessons);
 
     const std::vector<SubjectRequest>& SubjectRequests() const { return subjectRequests_; }
     const SubjectRequest& SubjectRequestAtID(std::size_t subjectRequestID) const;
@@ -158,16 +329,50 @@ public:
     const std::vector<SubjectWithAddress>& LockedLessons() const { return lockedLessons_; }
     bool SubjectRequestHasLockedLesson(const SubjectRequest& request) const;
 
+    const LessonsMask& RequestedLessons(std::size_t r) const { return requestsInfo_[r].RequestedLessons; }
+    bool RequestHasLockedLesson(std::size_t r) const { return requestsInfo_[r].HasLockedLesson; }
+
     const std::unordered_map<std::size_t, std::unordered_set<std::size_t>>& Professors() const { return professorRequests_; }
     const std::unordered_map<std::size_t, std::unordered_set<std::size_t>>& Groups() const { return groupRequests_; }
 
+    // dense indexes of professors and groups, used to rescore only entities touched by a request
+    const std::vector<std::vector<std::size_t>>& ProfessorsRequests() const { return professorsRequests_; }
+    const std::vector<std::vector<std::size_t>>& GroupsRequests() const { return groupsRequests_; }
+    std::size_t RequestProfessorIndex(std::size_t r) const { return requestsInfo_[r].ProfessorIndex; }
+    const std::vector<std::size_t>& RequestGroupsIndices(std::size_t r) const { return requestsGroups_[r]; }
+    // identifiers of professors and groups by their dense indexes
+    std::size_t ProfessorID(std::size_t p) const { return subjectRequests_[professorsRequests_.at(p).front()].Professor(); }
+    std::size_t GroupID(std::size_t g) const;
+
+    const RequestsConflictGraph& ConflictGraph() const { return conflictGraph_; }
+    bool RequestsConflicts(std::size_t lhs, std::size_t rhs) const { return conflictGraph_.Adjacent(lhs, rhs); }
+
+    // connected components of requests linked by common professors, groups or classroom candidates,
+    // requests of different components never affect each other's placement or evaluation
+    const std::vector<std::vector<std::size_t>>& Components() const { return components_; }
+
+    // independent problem made of given requests (sorted indices) and their locked lessons,
+    // request i of the result corresponds to requests[i]
+    BasicScheduleData ComponentData(const std::vector<std::size_t>& requests) const;
+
+    // bytes of the data object together with requests and all precomputed indexes
+    std::size_t MemoryUsage() const;
+
 private:
     std::vector<SubjectRequest> subjectRequests_;
     std::vector<SubjectWithAddress> lockedLessons_;
     std::unordered_map<std::size_t, std::unordered_set<std::size_t>> professorRequests_;
     std::unordered_map<std::size_t, std::unordered_set<std::size_t>> groupRequests_;
+    RequestsConflictGraph conflictGraph_;
+    std::vector<SubjectRequestStaticInfo> requestsInfo_;
+    std::vector<std::vector<std::size_t>> professorsRequests_;
+    std::vector<std::vector<std::size_t>> groupsRequests_;
+    std::vector<std::vector<std::size_t>> requestsGroups_;
+    std::vector<std::vector<std::size_t>> components_;
 };
 
+using ScheduleData = BasicScheduleData<DefaultScheduleCalendar>;
+
 template<typename T>
 std::vector<T> Merge(const std::vector<T>& lhs,
                      const std::vector<T>& rhs)
@@ -179,107 +384,3 @@ std::vector<T> Merge(const std::vector<T>& lhs,
     std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(tmp));
     return tmp;
 }
-
-constexpr bool IsLateScheduleLessonInSaturday(std::size_t l)
-{
-    constexpr std::array lateSaturdayLessonsTable = {
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        true,
-        true,
-        true,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-        false,
-
-        false,
-        false,
-        false,
-        false,
-        true,
-        true,
-        true,
-    };
-
-    static_assert(lateSaturdayLessonsTable.size() == MAX_LESSONS_COUNT, "re-fill lateSaturdayLessonsTable");
-    return lateSaturdayLessonsTable[l];
-}
@@ -0,0 +1,84 @@
+#include "ScheduleCounters.h"
+
+#include <mutex>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+
+// Registry of live per-thread blocks, counters of finished threads are folded into RetiredValues
+struct ScheduleCountersRegistry
+{
+    std::mutex Mutex;
+    std::vector<const ScheduleThreadCounters*> Threads;
+    ScheduleCountersValues RetiredValues = {};
+};
+
+static ScheduleCountersRegistry& CountersRegistry()
+{
+    // never destroyed: thread_local blocks of detached threads may outlive static objects
+    static auto* pRegistry = new ScheduleCountersRegistry();
+    return *pRegistry;
+}
+
+
+std::string_view ScheduleCounterName(ScheduleCounter counter)
+{
+    switch(counter)
+    {
+    case ScheduleCounter::ChangeLessonCalls: return "ChangeLessonCalls";
+    case ScheduleCounter::ChangeLessonFailures: return "ChangeLessonFailures";
+    case ScheduleCounter::ChangeClassroomCalls: return "ChangeClassroomCalls";
+    case ScheduleCounter::ChangeClassroomFailures: return "ChangeClassroomFailures";
+    case ScheduleCounter::ChangeClassroomTries: return "ChangeClassroomTries";
+    case ScheduleCounter::CrossoverCalls: return "CrossoverCalls";
+    case ScheduleCounter::CrossoverRejections: return "CrossoverRejections";
+    case ScheduleCounter::ConflictCheckIterations: return "ConflictCheckIterations";
+    case ScheduleCounter::GenesCopies: return "GenesCopies";
+    case ScheduleCounter::Count: break;
+    }
+
+    assert(false && "Unknown counter");
+    return "Unknown";
+}
+
+ScheduleThreadCounters::ScheduleThreadCounters()
+{
+    auto& registry = CountersRegistry();
+    std::lock_guard lock(registry.Mutex);
+    registry.Threads.emplace_back(this);
+}
+
+ScheduleThreadCounters::~ScheduleThreadCounters()
+{
+    auto& registry = CountersRegistry();
+    std::lock_guard lock(registry.Mutex);
+    for(std::size_t c = 0; c < Values.size(); ++c)
+        registry.RetiredValues[c] += Values[c].load(std::memory_order_relaxed);
+
+    std::erase(registry.Threads, this);
+}
+
+ScheduleThreadCounters& CurrentThreadScheduleCounters()
+{
+    thread_local ScheduleThreadCounters counters;
+    return counters;
+}
+
+ScheduleCountersValues CollectScheduleCounters()
+{
+    if constexpr(!SCHEDULE_COUNTERS_ENABLED)
+        return {};
+
+    auto& registry = CountersRegistry();
+    std::lock_guard lock(registry.Mutex);
+
+    ScheduleCountersValues result = registry.RetiredValues;
+    for(const auto* pThreadCounters : registry.Threads)
+    {
+        for(std::size_t c = 0; c < result.size(); ++c)
+            result[c] += pThreadCounters->Values[c].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+
+#ifdef SCHEDULE_GA_COUNTERS
+constexpr bool SCHEDULE_COUNTERS_ENABLED = true;
+#else
+constexpr bool SCHEDULE_COUNTERS_ENABLED = false;
+#endif
+
+
+enum class ScheduleCounter : std::size_t
+{
+    ChangeLessonCalls,
+    // request is locked or has no free lessons, mutation does nothing
+    ChangeLessonFailures,
+    ChangeClassroomCalls,
+    // every tried classroom is occupied, mutation does nothing
+    ChangeClassroomFailures,
+    ChangeClassroomTries,
+    CrossoverCalls,
+    CrossoverRejections,
+    // requests visited while looking for intersections by groups, professors or classrooms
+    ConflictCheckIterations,
+    // gene vectors cloned by the first change of a copy sharing them
+    GenesCopies,
+    Count
+};
+
+using ScheduleCountersValues = std::array<std::uint64_t, static_cast<std::size_t>(ScheduleCounter::Count)>;
+
+std::string_view ScheduleCounterName(ScheduleCounter counter);
+
+
+// Per-thread block, only the owner thread writes it, so increments are plain relaxed load and store
+struct ScheduleThreadCounters
+{
+    ScheduleThreadCounters();
+    ~ScheduleThreadCounters();
+
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(ScheduleCounter::Count)> Values = {};
+};
+
+ScheduleThreadCounters& CurrentThreadScheduleCounters();
+
+
+// Adds n to the counter of the current thread, does nothing if counters are compiled out
+inline void CountScheduleEvent(ScheduleCounter counter, std::uint64_t n = 1)
+{
+    if constexpr(SCHEDULE_COUNTERS_ENABLED)
+    {
+        auto& value = CurrentThreadScheduleCounters().Values[static_cast<std::size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+}
+
+// Sum of counters of all threads including finished ones, zeros if counters are compiled out
+ScheduleCountersValues CollectScheduleCounters();
@@ -0,0 +1,664 @@
+#include "ScheduleDaemon.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+
+static constexpr std::size_t READ_CHUNK_SIZE = 4096;
+
+
+// Client socket shared by the connection thread and jobs streaming their progress
+class ScheduleDaemonConnection
+{
+public:
+    explicit ScheduleDaemonConnection(int fd)
+        : fd_(fd)
+    { }
+
+    ~ScheduleDaemonConnection() { close(fd_); }
+
+    ScheduleDaemonConnection(const ScheduleDaemonConnection&) = delete;
+    ScheduleDaemonConnection& operator=(const ScheduleDaemonConnection&) = delete;
+
+    // lines of different senders are never interleaved, errors of disconnected clients are ignored
+    void Send(std::string line)
+    {
+        line += '\n';
+        std::lock_guard lock(writeMutex_);
+        for(std::size_t written = 0; written < line.size();)
+        {
+            const ssize_t result = send(fd_, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+            if(result < 0 && errno == EINTR)
+                continue;
+
+            if(result <= 0)
+                return;
+
+            written += static_cast<std::size_t>(result);
+        }
+    }
+
+    // returns std::nullopt when client has disconnected, called by the connection thread only
+    std::optional<std::string> ReadLine()
+    {
+        for(;;)
+        {
+            if(const auto endOfLine = readBuffer_.find('\n'); endOfLine != std::string::npos)
+            {
+                std::string line = readBuffer_.substr(0, endOfLine);
+                readBuffer_.erase(0, endOfLine + 1);
+                if(!line.empty() && line.back() == '\r')
+                    line.pop_back();
+
+                return line;
+            }
+
+            char chunk[READ_CHUNK_SIZE];
+            const ssize_t result = recv(fd_, chunk, sizeof(chunk), 0);
+            if(result < 0 && errno == EINTR)
+                continue;
+
+            if(result <= 0)
+                return std::nullopt;
+
+            readBuffer_.append(chunk, static_cast<std::size_t>(result));
+        }
+    }
+
+    // wakes up the connection thread blocked in ReadLine
+    void Shutdown() { shutdown(fd_, SHUT_RDWR); }
+
+private:
+    int fd_;
+    std::mutex writeMutex_;
+    std::string readBuffer_;
+};
+
+
+// Puts given schedule into the population once, after the first generation
+template<typename Calendar>
+class SeedMigration : public BasicScheduleGAMigration<Calendar>
+{
+public:
+    explicit SeedMigration(std::shared_ptr<const BasicScheduleChromosomes<Calendar>> pSeed)
+        : pSeed_(std::move(pSeed))
+    { }
+
+    void Emigrate(const BasicScheduleChromosomes<Calendar>&, std::size_t) override { }
+
+    std::vector<BasicScheduleChromosomes<Calendar>> Immigrate() override
+    {
+        std::vector<BasicScheduleChromosomes<Calendar>> immigrants;
+        if(pSeed_ != nullptr)
+            immigrants.emplace_back(*pSeed_);
+
+        pSeed_ = nullptr;
+        return immigrants;
+    }
+
+private:
+    std::shared_ptr<const BasicScheduleChromosomes<Calendar>> pSeed_;
+};
+
+
+static std::string NextToken(std::istringstream& is, const char* name)
+{
+    std::string token;
+    if(!(is >> token))
+        throw std::invalid_argument(std::string("missing ") + name);
+
+    return token;
+}
+
+static std::size_t ParseNumber(const std::string& token, const char* name)
+{
+    std::size_t parsed = 0;
+    const std::size_t value = std::stoull(token, &parsed);
+    if(parsed != token.size() || token.front() == '-')
+        throw std::invalid_argument(std::string("invalid ") + name + ": " + token);
+
+    return value;
+}
+
+static std::size_t NextNumber(std::istringstream& is, const char* name)
+{
+    const std::string token = NextToken(is, name);
+    try
+    {
+        return ParseNumber(token, name);
+    }
+    catch(const std::logic_error&)
+    {
+        throw std::invalid_argument(std::string("invalid ") + name + ": " + token);
+    }
+}
+
+static std::vector<std::string> SplitList(const std::string& token, char separator)
+{
+    std::vector<std::string> items;
+    if(token == "-")
+        return items;
+
+    std::size_t begin = 0;
+    for(std::size_t end = token.find(separator); end != std::string::npos; end = token.find(separator, begin))
+    {
+        items.emplace_back(token.substr(begin, end - begin));
+        begin = end + 1;
+    }
+
+    items.emplace_back(token.substr(begin));
+    return items;
+}
+
+static SubjectRequest ParseSubjectRequest(const std::string& line)
+{
+    std::istringstream is(line);
+    const std::size_t id = NextNumber(is, "request id");
+    const std::size_t professor = NextNumber(is, "professor");
+    const std::size_t complexity = NextNumber(is, "complexity");
+
+    std::vector<bool> weekDays;
+    if(const std::string days = NextToken(is, "week days"); days != "-")
+    {
+        for(char day : days)
+        {
+            if(day != '0' && day != '1')
+                throw std::invalid_argument("invalid week days: " + days);
+
+            weekDays.emplace_back(day == '1');
+        }
+    }
+
+    std::vector<std::size_t> groups;
+    for(const auto& group : SplitList(NextToken(is, "groups"), ','))
+        groups.emplace_back(ParseNumber(group, "group"));
+
+    std::vector<ClassroomAddress> classrooms;
+    for(const auto& classroom : SplitList(NextToken(is, "classrooms"), ','))
+    {
+        const auto address = SplitList(classroom, ':');
+        if(address.size() != 2)
+            throw std::invalid_argument("invalid classroom: " + classroom);
+
+        classrooms.emplace_back(ParseNumber(address[0], "building"), ParseNumber(address[1], "classroom"));
+    }
+
+    return SubjectRequest(id, professor, complexity, std::move(weekDays), std::move(groups), std::move(classrooms));
+}
+
+template<typename Calendar>
+static std::vector<SubjectWithAddress> ReadLockedLessons(ScheduleDaemonConnection& connection, std::size_t count)
+{
+    // all lines are consumed even if some of them are invalid, so that they are not taken for commands
+    std::vector<SubjectWithAddress> lockedLessons;
+    std::string firstError;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const auto line = connection.ReadLine();
+        if(!line)
+            throw std::invalid_argument("connection closed before all locked lessons were received");
+
+        try
+        {
+            std::istringstream is(*line);
+            const std::size_t requestID = NextNumber(is, "locked request id");
+            const std::size_t lesson = NextNumber(is, "locked lesson");
+            if(lesson >= Calendar::MaxLessonsCount)
+                throw std::invalid_argument("locked lesson is out of calendar: " + std::to_string(lesson));
+
+            lockedLessons.emplace_back(requestID, lesson);
+        }
+        catch(const std::invalid_argument& e)
+        {
+            if(firstError.empty())
+                firstError = "locked lesson " + std::to_string(i) + ": " + e.what();
+        }
+    }
+
+    if(!firstError.empty())
+        throw std::invalid_argument(firstError);
+
+    return lockedLessons;
+}
+
+static std::string FormatAddress(std::size_t value)
+{
+    return value == std::numeric_limits<std::size_t>::max() ? "-" : std::to_string(value);
+}
+
+template<typename Calendar>
+static std::string FormatResult(std::size_t jobID,
+                                std::size_t fitness,
+                                const BasicScheduleChromosomes<Calendar>& chromosomes,
+                                const BasicScheduleData<Calendar>& data)
+{
+    // schedule data keeps requests sorted by ID, so every address is labelled with its request ID
+    std::string line = "result " + std::to_string(jobID) + ' ' + std::to_string(fitness);
+    for(std::size_t r = 0; r < chromosomes.Lessons().size(); ++r)
+    {
+        const ClassroomAddress classroom = chromosomes.Classroom(r);
+        line += ' ' + std::to_string(data.SubjectRequests()[r].ID()) + '=' + FormatAddress(chromosomes.Lesson(r)) + ':' +
+                FormatAddress(classroom.Building) + ':' + FormatAddress(classroom.Classroom);
+    }
+
+    return line;
+}
+
+
+template<typename Calendar>
+BasicScheduleDaemon<Calendar>::BasicScheduleDaemon(ScheduleDaemonParams params)
+    : params_(std::move(params))
+{
+    if(params_.SocketPath.empty() || params_.SocketPath.size() >= sizeof(sockaddr_un::sun_path))
+        throw std::invalid_argument("Invalid SocketPath option: must be non-empty and shorter than " +
+                                    std::to_string(sizeof(sockaddr_un::sun_path)) + " characters");
+
+    if(params_.ConcurrentJobs <= 0)
+        throw std::invalid_argument("Invalid ConcurrentJobs option: must be greater than zero");
+
+    if(params_.ProgressInterval < 0)
+        throw std::invalid_argument("Invalid ProgressInterval option: must be greater or equal to zero");
+
+    // validates solver params before any job is accepted
+    const BasicScheduleGA<Calendar> validatedParams(params_.GAParams);
+}
+
+template<typename Calendar>
+BasicScheduleDaemon<Calendar>::~BasicScheduleDaemon()
+{
+    Stop();
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::Start()
+{
+    if(listenFd_ >= 0)
+        throw std::logic_error("Daemon is already started");
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd_ < 0)
+        throw std::runtime_error(std::string("Unable to create socket: ") + std::strerror(errno));
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::ranges::copy(params_.SocketPath, address.sun_path);
+
+    unlink(params_.SocketPath.c_str());
+    if(bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd_, SOMAXCONN) != 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(listenFd_);
+        listenFd_ = -1;
+        throw std::runtime_error("Unable to listen on " + params_.SocketPath + ": " + error);
+    }
+
+    stopping_ = false;
+    for(int i = 0; i < params_.ConcurrentJobs; ++i)
+        workers_.emplace_back(&BasicScheduleDaemon::SolveJobs, this);
+
+    acceptThread_ = std::thread(&BasicScheduleDaemon::AcceptConnections, this);
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::Stop()
+{
+    if(listenFd_ < 0)
+        return;
+
+    stopping_ = true;
+
+    // unblocks accept
+    shutdown(listenFd_, SHUT_RDWR);
+    acceptThread_.join();
+
+    std::list<ConnectionThread> connectionThreads;
+    {
+        std::lock_guard lock(connectionsMutex_);
+        for(auto& pConnection : connections_)
+        {
+            if(auto pAlive = pConnection.lock())
+                pAlive->Shutdown();
+        }
+
+        connections_.clear();
+        connectionThreads.swap(connectionThreads_);
+    }
+
+    for(auto& connectionThread : connectionThreads)
+        connectionThread.Thread.join();
+
+    {
+        std::lock_guard lock(jobsMutex_);
+        jobs_.clear();
+        for(auto&& [id, pState] : runningJobs_)
+            pState->RequestStop();
+    }
+
+    jobsChanged_.notify_all();
+    for(auto& worker : workers_)
+        worker.join();
+
+    workers_.clear();
+    close(listenFd_);
+    listenFd_ = -1;
+    unlink(params_.SocketPath.c_str());
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::AcceptConnections()
+{
+    while(!stopping_)
+    {
+        const int clientFd = accept(listenFd_, nullptr, nullptr);
+        if(clientFd < 0)
+        {
+            if(errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            return;
+        }
+
+        auto pConnection = std::make_shared<ScheduleDaemonConnection>(clientFd);
+        auto pFinished = std::make_shared<std::atomic<bool>>(false);
+
+        std::lock_guard lock(connectionsMutex_);
+        if(stopping_)
+            return;
+
+        // threads of closed connections are joined lazily
+        std::erase_if(connectionThreads_, [](ConnectionThread& connectionThread)
+        {
+            if(!connectionThread.Finished->load())
+                return false;
+
+            connectionThread.Thread.join();
+            return true;
+        });
+
+        std::erase_if(connections_, [](const auto& pConnection) { return pConnection.expired(); });
+        connections_.emplace_back(pConnection);
+        connectionThreads_.push_back(ConnectionThread{
+            .Thread = std::thread([this, pConnection, pFinished]
+            {
+                ServeConnection(pConnection);
+                pFinished->store(true);
+            }),
+            .Finished = pFinished
+        });
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::ServeConnection(const std::shared_ptr<ScheduleDaemonConnection>& pConnection)
+{
+    while(!stopping_)
+    {
+        const auto line = pConnection->ReadLine();
+        if(!line)
+            return;
+
+        if(line->empty())
+            continue;
+
+        try
+        {
+            HandleCommand(pConnection, *line);
+        }
+        catch(const std::exception& e)
+        {
+            pConnection->Send(std::string("error ") + e.what());
+        }
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::HandleCommand(const std::shared_ptr<ScheduleDaemonConnection>& pConnection, const std::string& line)
+{
+    std::istringstream is(line);
+    const std::string command = NextToken(is, "command");
+
+    if(command == "load")
+    {
+        const std::string name = NextToken(is, "dataset");
+        const std::size_t requestsCount = NextNumber(is, "requests count");
+        const std::size_t lockedCount = NextNumber(is, "locked lessons count");
+
+        // all lines of the command are consumed even if some of them are invalid
+        std::vector<SubjectRequest> requests;
+        std::string firstError;
+        for(std::size_t r = 0; r < requestsCount; ++r)
+        {
+            const auto requestLine = pConnection->ReadLine();
+            if(!requestLine)
+                return;
+
+            try
+            {
+                requests.emplace_back(ParseSubjectRequest(*requestLine));
+            }
+            catch(const std::exception& e)
+            {
+                if(firstError.empty())
+                    firstError = "request " + std::to_string(r) + ": " + e.what();
+            }
+        }
+
+        auto lockedLessons = ReadLockedLessons<Calendar>(*pConnection, lockedCount);
+        if(!firstError.empty())
+            throw std::invalid_argument(firstError);
+
+        if(requests.empty())
+            throw std::invalid_argument("dataset must have at least one request");
+
+        auto pData = std::make_shared<const ScheduleData>(std::move(requests), std::move(lockedLessons));
+        {
+            std::lock_guard lock(datasetsMutex_);
+            datasets_[name] = Dataset{.Data = pData, .Best = nullptr};
+        }
+
+        pConnection->Send("loaded " + name + ' ' + std::to_string(pData->SubjectRequests().size()));
+    }
+    else if(command == "unload")
+    {
+        const std::string name = NextToken(is, "dataset");
+        std::lock_guard lock(datasetsMutex_);
+        if(datasets_.erase(name) == 0)
+            throw std::invalid_argument("unknown dataset " + name);
+
+        pConnection->Send("unloaded " + name);
+    }
+    else if(command == "solve" || command == "resolve" || command == "whatif")
+    {
+        const std::string name = NextToken(is, "dataset");
+        const std::size_t iterationsCount = NextNumber(is, "iterations count");
+        if(iterationsCount > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+            throw std::invalid_argument("invalid iterations count");
+
+        Dataset dataset;
+        {
+            std::lock_guard lock(datasetsMutex_);
+            const auto it = datasets_.find(name);
+            if(it != datasets_.end())
+                dataset = it->second;
+        }
+
+        Job job{
+            .Connection = pConnection,
+            .DatasetName = name,
+            .Data = dataset.Data,
+            .Seed = nullptr,
+            .IterationsCount = static_cast<int>(iterationsCount)
+        };
+
+        if(command == "whatif")
+        {
+            // locked lessons lines are consumed before the dataset is checked
+            auto lockedLessons = ReadLockedLessons<Calendar>(*pConnection, NextNumber(is, "locked lessons count"));
+            if(dataset.Data == nullptr)
+                throw std::invalid_argument("unknown dataset " + name);
+
+            lockedLessons.insert(lockedLessons.begin(), dataset.Data->LockedLessons().begin(), dataset.Data->LockedLessons().end());
+            job.Data = std::make_shared<const ScheduleData>(dataset.Data->SubjectRequests(), std::move(lockedLessons));
+            job.DatasetName.clear();
+        }
+
+        if(dataset.Data == nullptr)
+            throw std::invalid_argument("unknown dataset " + name);
+
+        if(command == "resolve")
+            job.Seed = dataset.Best;
+
+        EnqueueJob(std::move(job));
+    }
+    else if(command == "stop")
+    {
+        StopJob(NextNumber(is, "job"));
+    }
+    else
+    {
+        throw std::invalid_argument("unknown command " + command);
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::EnqueueJob(Job job)
+{
+    {
+        std::lock_guard lock(jobsMutex_);
+        job.ID = nextJobID_++;
+        job.Connection->Send("queued " + std::to_string(job.ID));
+        jobs_.emplace_back(std::move(job));
+    }
+
+    jobsChanged_.notify_one();
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::StopJob(std::size_t jobID)
+{
+    std::lock_guard lock(jobsMutex_);
+    if(const auto it = runningJobs_.find(jobID); it != runningJobs_.end())
+    {
+        // running job sends its result as usual
+        it->second->RequestStop();
+        return;
+    }
+
+    const auto it = std::ranges::find(jobs_, jobID, &Job::ID);
+    if(it == jobs_.end())
+        throw std::invalid_argument("unknown job " + std::to_string(jobID));
+
+    it->Connection->Send("stopped " + std::to_string(jobID));
+    jobs_.erase(it);
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::SolveJobs()
+{
+    for(;;)
+    {
+        Job job;
+        {
+            std::unique_lock lock(jobsMutex_);
+            jobsChanged_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if(stopping_)
+                return;
+
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        try
+        {
+            Solve(job);
+        }
+        catch(const std::exception& e)
+        {
+            job.Connection->Send("error job " + std::to_string(job.ID) + ": " + e.what());
+        }
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleDaemon<Calendar>::Solve(const Job& job)
+{
+    ScheduleGAParams params = params_.GAParams;
+    params.IterationsCount = job.IterationsCount;
+
+    // best schedule of the dataset enters the population as an immigrant after the first generation
+    const bool seeded = job.Seed != nullptr && job.Seed->Lessons().size() == job.Data->SubjectRequests().size();
+    if(seeded)
+        params.MigrationInterval = 1;
+
+    SeedMigration<Calendar> seedMigration(job.Seed);
+    BasicScheduleGA<Calendar> algo(params);
+    if(seeded)
+        algo.SetMigration(&seedMigration);
+
+    const std::size_t progressInterval = params_.ProgressInterval;
+    BasicScheduleGARunState<Calendar> state([&job, progressInterval](const ScheduleGAProgress& progress)
+    {
+        if(progressInterval > 0 && progress.Iteration % progressInterval == 0)
+        {
+            job.Connection->Send("progress " + std::to_string(job.ID) + ' ' + std::to_string(progress.Iteration) + ' ' +
+                                 std::to_string(progress.BestFitness));
+        }
+    });
+
+    {
+        std::lock_guard lock(jobsMutex_);
+        runningJobs_.emplace(job.ID, &state);
+        if(stopping_)
+            state.RequestStop();
+    }
+
+    // job runs on the worker thread itself, so that ConcurrentJobs bounds the number of solver threads
+    try
+    {
+        algo.Start(*job.Data, state);
+    }
+    catch(...)
+    {
+        std::lock_guard lock(jobsMutex_);
+        runningJobs_.erase(job.ID);
+        throw;
+    }
+
+    {
+        std::lock_guard lock(jobsMutex_);
+        runningJobs_.erase(job.ID);
+    }
+
+    const auto pBest = state.Best();
+    if(pBest == nullptr)
+    {
+        job.Connection->Send("stopped " + std::to_string(job.ID));
+        return;
+    }
+
+    if(!job.DatasetName.empty())
+    {
+        std::lock_guard lock(datasetsMutex_);
+        const auto it = datasets_.find(job.DatasetName);
+        if(it != datasets_.end() && it->second.Data == job.Data && (it->second.Best == nullptr || pBest->Fitness < it->second.BestFitness))
+        {
+            it->second.Best = std::make_shared<const ScheduleChromosomes>(pBest->Chromosomes);
+            it->second.BestFitness = pBest->Fitness;
+        }
+    }
+
+    job.Connection->Send(FormatResult(job.ID, pBest->Fitness, pBest->Chromosomes, *job.Data));
+}
+
+
+template class BasicScheduleDaemon<DefaultScheduleCalendar>;
+template class BasicScheduleDaemon<EightLessonsScheduleCalendar>;
+template class BasicScheduleDaemon<OneWeekScheduleCalendar>;
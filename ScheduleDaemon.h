@@ -0,0 +1,124 @@
+#pragma once
+#include "ScheduleCommon.h"
+#include "ScheduleChromosomes.h"
+#include "ScheduleGA.h"
+
+#include <map>
+#include <list>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+
+struct ScheduleDaemonParams
+{
+    // path of the Unix domain socket, existing file is replaced
+    std::string SocketPath;
+    // jobs solved at the same time, parallel phases of all of them share one thread pool
+    int ConcurrentJobs = 1;
+    // parameters of every job, IterationsCount is given by the job itself
+    ScheduleGAParams GAParams;
+    // generations between progress lines sent to the client, zero disables progress
+    int ProgressInterval = 10;
+};
+
+
+class ScheduleDaemonConnection;
+
+
+// Long-running solver serving local clients (POSIX only). Loaded datasets keep their precomputed
+// indexes between jobs. Every message is a single line of space separated tokens:
+//
+//   load <dataset> <requests count> <locked count>      followed by request lines
+//       "<id> <professor> <complexity> <week days: 0/1 per day or -> <groups: g,g or -> <classrooms: b:c,b:c or ->"
+//       and locked lesson lines "<request id> <lesson>"; replies "loaded <dataset> <requests count>"
+//   unload <dataset>                                     replies "unloaded <dataset>"
+//   solve <dataset> <iterations>                         replies "queued <job>"
+//   resolve <dataset> <iterations>                       same, population is seeded with the best schedule found for the dataset
+//                                                        (in generational mode, as an immigrant after the first generation)
+//   whatif <dataset> <iterations> <locked count>         followed by locked lesson lines, solves a copy of the dataset
+//                                                        with additional locked lessons, dataset itself is not changed
+//   stop <job>                                           finishes queued or running job early
+//
+// Jobs send "progress <job> <iteration> <best fitness>" while running and finish with
+// "result <job> <fitness> <request id>=<lesson>:<building>:<classroom> ..." for every distinct request ID in ascending order
+// (repeated IDs of a dataset keep the first request), missing values are '-'.
+// Errors are reported as "error <message>" and do not close the connection.
+template<typename Calendar>
+class BasicScheduleDaemon
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+    using ScheduleChromosomes = BasicScheduleChromosomes<Calendar>;
+
+    explicit BasicScheduleDaemon(ScheduleDaemonParams params);
+    ~BasicScheduleDaemon();
+
+    BasicScheduleDaemon(const BasicScheduleDaemon&) = delete;
+    BasicScheduleDaemon& operator=(const BasicScheduleDaemon&) = delete;
+
+    // binds the socket, connections and jobs are served by background threads
+    void Start();
+    // closes connections, stops running jobs and waits for background threads, removes the socket file
+    void Stop();
+
+private:
+    struct Dataset
+    {
+        std::shared_ptr<const ScheduleData> Data;
+        std::shared_ptr<const ScheduleChromosomes> Best;
+        std::size_t BestFitness = 0;
+    };
+
+    struct Job
+    {
+        std::size_t ID = 0;
+        std::shared_ptr<ScheduleDaemonConnection> Connection;
+        // empty for what-if jobs, their results are not kept
+        std::string DatasetName;
+        std::shared_ptr<const ScheduleData> Data;
+        std::shared_ptr<const ScheduleChromosomes> Seed;
+        int IterationsCount = 0;
+    };
+
+    struct ConnectionThread
+    {
+        std::thread Thread;
+        std::shared_ptr<std::atomic<bool>> Finished;
+    };
+
+    void AcceptConnections();
+    void ServeConnection(const std::shared_ptr<ScheduleDaemonConnection>& pConnection);
+    void HandleCommand(const std::shared_ptr<ScheduleDaemonConnection>& pConnection, const std::string& line);
+    void EnqueueJob(Job job);
+    void StopJob(std::size_t jobID);
+    void SolveJobs();
+    void Solve(const Job& job);
+
+private:
+    ScheduleDaemonParams params_;
+    int listenFd_ = -1;
+    std::atomic<bool> stopping_ = false;
+    std::thread acceptThread_;
+    std::vector<std::thread> workers_;
+
+    std::mutex connectionsMutex_;
+    std::list<ConnectionThread> connectionThreads_;
+    std::vector<std::weak_ptr<ScheduleDaemonConnection>> connections_;
+
+    std::mutex datasetsMutex_;
+    std::map<std::string, Dataset> datasets_;
+
+    std::mutex jobsMutex_;
+    std::condition_variable jobsChanged_;
+    std::deque<Job> jobs_;
+    std::size_t nextJobID_ = 1;
+    std::map<std::size_t, BasicScheduleGARunState<Calendar>*> runningJobs_;
+};
+
+using ScheduleDaemon = BasicScheduleDaemon<DefaultScheduleCalendar>;
@@ -0,0 +1,47 @@
+#include "ScheduleDaemon.h"
+
+#include <iostream>
+#include <csignal>
+#include <string>
+
+
+// usage: ScheduleDaemon <socket path> [concurrent jobs]
+int main(int argc, char* argv[])
+{
+	if(argc < 2 || argc > 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <socket path> [concurrent jobs]" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		ScheduleDaemonParams params;
+		params.SocketPath = argv[1];
+		params.GAParams = ScheduleGA::DefaultParams();
+		if(argc == 3)
+			params.ConcurrentJobs = std::stoi(argv[2]);
+
+		// signals are blocked before background threads are started, so that only sigwait receives them
+		sigset_t signals;
+		sigemptyset(&signals);
+		sigaddset(&signals, SIGINT);
+		sigaddset(&signals, SIGTERM);
+		pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+		ScheduleDaemon daemon(params);
+		daemon.Start();
+		std::cout << "Listening on " << params.SocketPath << std::endl;
+
+		int signal = 0;
+		sigwait(&signals, &signal);
+		daemon.Stop();
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
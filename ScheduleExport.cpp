@@ -0,0 +1,441 @@
+#include "ScheduleExport.h"
+
+#include <map>
+#include <charconv>
+#include <execution>
+#include <algorithm>
+#include <string_view>
+
+
+static constexpr std::size_t WRITER_BUFFER_SIZE = 1 << 20;
+static constexpr std::size_t PARALLEL_EXPORT_CHUNK_SIZE = 1024;
+
+
+// Appends text to a large buffer and writes it to the stream in big blocks
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(std::ostream& os)
+        : os_(os)
+    {
+        buffer_.reserve(WRITER_BUFFER_SIZE);
+    }
+
+    ~BufferedWriter() { Flush(); }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void Write(std::string_view text)
+    {
+        buffer_.append(text);
+        Commit();
+    }
+
+    // text is appended here directly, then Commit() writes it out once the block is full
+    std::string& Buffer() { return buffer_; }
+
+    void Commit()
+    {
+        if(buffer_.size() >= WRITER_BUFFER_SIZE)
+            Flush();
+    }
+
+    void Flush()
+    {
+        os_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+private:
+    std::ostream& os_;
+    std::string buffer_;
+};
+
+
+static void AppendNumber(std::string& out, std::size_t value)
+{
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    out.append(digits, result.ptr);
+}
+
+static void AppendPadded(std::string& out, std::size_t value, std::size_t width)
+{
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    const std::size_t length = result.ptr - digits;
+    if(length < width)
+        out.append(width - length, '0');
+
+    out.append(digits, result.ptr);
+}
+
+
+template<typename Calendar>
+BasicScheduleSlots<Calendar>::BasicScheduleSlots(const BasicScheduleChromosomes<Calendar>& chromosomes)
+{
+    const auto& lessons = chromosomes.Lessons();
+    for(std::size_t lesson : lessons)
+    {
+        if(lesson < Calendar::MaxLessonsCount)
+            ++offsets_[lesson + 1];
+    }
+
+    for(std::size_t l = 0; l < Calendar::MaxLessonsCount; ++l)
+        offsets_[l + 1] += offsets_[l];
+
+    requests_.resize(offsets_.back());
+    auto positions = offsets_;
+    for(std::size_t r = 0; r < lessons.size(); ++r)
+    {
+        if(lessons[r] < Calendar::MaxLessonsCount)
+            requests_[positions[lessons[r]]++] = r;
+    }
+}
+
+
+// (building, classroom) for classrooms, (0, ID) for groups and professors
+using TimetableKey = std::pair<std::size_t, std::size_t>;
+
+struct ExportTimetable
+{
+    TimetableKey Key;
+    // request indices sorted by lesson
+    std::vector<std::size_t> Requests;
+};
+
+template<typename Calendar>
+static std::vector<ExportTimetable> MakeTimetables(const BasicScheduleChromosomes<Calendar>& chromosomes,
+                                                   const BasicScheduleData<Calendar>& data,
+                                                   ScheduleExportView view)
+{
+    const BasicScheduleSlots<Calendar> slots(chromosomes);
+    const auto& requests = data.SubjectRequests();
+
+    std::map<TimetableKey, std::vector<std::size_t>> timetables;
+    for(std::size_t lesson = 0; lesson < Calendar::MaxLessonsCount; ++lesson)
+    {
+        for(std::size_t r : slots.Requests(lesson))
+        {
+            const auto& request = requests[r];
+            switch(view)
+            {
+            case ScheduleExportView::Groups:
+                for(std::size_t g : request.Groups())
+                    timetables[TimetableKey(0, g)].emplace_back(r);
+                break;
+            case ScheduleExportView::Professors:
+                timetables[TimetableKey(0, request.Professor())].emplace_back(r);
+                break;
+            case ScheduleExportView::Classrooms:
+                if(const auto classroom = chromosomes.Classroom(r); HasClassroom(classroom))
+                {
+                    timetables[TimetableKey(classroom.Building, classroom.Classroom)].emplace_back(r);
+                }
+                break;
+            }
+        }
+    }
+
+    std::vector<ExportTimetable> result;
+    result.reserve(timetables.size());
+    for(auto& [key, timetableRequests] : timetables)
+        result.push_back(ExportTimetable{.Key = key, .Requests = std::move(timetableRequests)});
+
+    return result;
+}
+
+// Any and NoClassroom are not real classrooms, so they are exported as empty fields
+static bool HasClassroom(const ClassroomAddress& classroom)
+{
+    return classroom != ClassroomAddress::Any() && classroom != ClassroomAddress::NoClassroom();
+}
+
+static std::string_view ViewName(ScheduleExportView view)
+{
+    switch(view)
+    {
+    case ScheduleExportView::Groups: return "group";
+    case ScheduleExportView::Professors: return "professor";
+    case ScheduleExportView::Classrooms: return "classroom";
+    }
+
+    return "unknown";
+}
+
+static void AppendTimetableID(std::string& out, ScheduleExportView view, const TimetableKey& key)
+{
+    if(view == ScheduleExportView::Classrooms)
+    {
+        AppendNumber(out, key.first);
+        out += '-';
+    }
+
+    AppendNumber(out, key.second);
+}
+
+
+template<typename Calendar>
+static void AppendCsv(std::string& out,
+                      const ExportTimetable& timetable,
+                      const BasicScheduleChromosomes<Calendar>& chromosomes,
+                      const BasicScheduleData<Calendar>& data,
+                      const ScheduleExportParams& params)
+{
+    for(std::size_t r : timetable.Requests)
+    {
+        const auto& request = data.SubjectRequests()[r];
+        const std::size_t lesson = chromosomes.Lesson(r);
+        const ClassroomAddress classroom = chromosomes.Classroom(r);
+
+        AppendTimetableID(out, params.View, timetable.Key);
+        out += ',';
+        AppendNumber(out, Calendar::Day(lesson));
+        out += ',';
+        AppendNumber(out, Calendar::DayLesson(lesson));
+        out += ',';
+        AppendNumber(out, request.ID());
+        out += ',';
+        AppendNumber(out, request.Professor());
+        out += ',';
+        if(HasClassroom(classroom))
+        {
+            AppendNumber(out, classroom.Building);
+            out += ',';
+            AppendNumber(out, classroom.Classroom);
+        }
+        else
+        {
+            out += ',';
+        }
+
+        out += ',';
+        for(std::size_t g = 0; g < request.Groups().size(); ++g)
+        {
+            if(g > 0)
+                out += ' ';
+
+            AppendNumber(out, request.Groups()[g]);
+        }
+
+        out += '\n';
+    }
+}
+
+template<typename Calendar>
+static void AppendJson(std::string& out,
+                       const ExportTimetable& timetable,
+                       const BasicScheduleChromosomes<Calendar>& chromosomes,
+                       const BasicScheduleData<Calendar>& data,
+                       const ScheduleExportParams& params)
+{
+    out += "{\"";
+    out += ViewName(params.View);
+    out += "\":\"";
+    AppendTimetableID(out, params.View, timetable.Key);
+    out += "\",\"lessons\":[";
+    for(std::size_t i = 0; i < timetable.Requests.size(); ++i)
+    {
+        const std::size_t r = timetable.Requests[i];
+        const auto& request = data.SubjectRequests()[r];
+        const std::size_t lesson = chromosomes.Lesson(r);
+        const ClassroomAddress classroom = chromosomes.Classroom(r);
+
+        if(i > 0)
+            out += ',';
+
+        out += "{\"day\":";
+        AppendNumber(out, Calendar::Day(lesson));
+        out += ",\"lesson\":";
+        AppendNumber(out, Calendar::DayLesson(lesson));
+        out += ",\"subject\":";
+        AppendNumber(out, request.ID());
+        out += ",\"professor\":";
+        AppendNumber(out, request.Professor());
+        if(HasClassroom(classroom))
+        {
+            out += ",\"building\":";
+            AppendNumber(out, classroom.Building);
+            out += ",\"classroom\":";
+            AppendNumber(out, classroom.Classroom);
+        }
+        else
+        {
+            out += ",\"building\":null,\"classroom\":null";
+        }
+
+        out += ",\"groups\":[";
+        for(std::size_t g = 0; g < request.Groups().size(); ++g)
+        {
+            if(g > 0)
+                out += ',';
+
+            AppendNumber(out, request.Groups()[g]);
+        }
+
+        out += "]}";
+    }
+
+    out += "]}";
+}
+
+template<typename Calendar>
+static void AppendICalendarEvents(std::string& out,
+                                  const ExportTimetable& timetable,
+                                  const BasicScheduleChromosomes<Calendar>& chromosomes,
+                                  const BasicScheduleData<Calendar>& data,
+                                  const ScheduleExportParams& params)
+{
+    using namespace std::chrono;
+
+    auto appendDateTime = [&](year_month_day date, minutes time)
+    {
+        AppendPadded(out, static_cast<int>(date.year()), 4);
+        AppendPadded(out, static_cast<unsigned>(date.month()), 2);
+        AppendPadded(out, static_cast<unsigned>(date.day()), 2);
+        out += 'T';
+        AppendPadded(out, time.count() / 60, 2);
+        AppendPadded(out, time.count() % 60, 2);
+        out += "00";
+    };
+
+    for(std::size_t r : timetable.Requests)
+    {
+        const auto& request = data.SubjectRequests()[r];
+        const std::size_t lesson = chromosomes.Lesson(r);
+        const ClassroomAddress classroom = chromosomes.Classroom(r);
+
+        const std::size_t day = Calendar::Day(lesson);
+        const std::size_t week = day / Calendar::DaysInScheduleWeek;
+        const year_month_day date{sys_days{params.FirstMonday} + days{week * 7 + Calendar::WeekDay(day)}};
+        const minutes begin = params.FirstLessonStart + Calendar::DayLesson(lesson) * (params.LessonDuration + params.BreakDuration);
+
+        out += "BEGIN:VEVENT\r\nUID:";
+        out += ViewName(params.View);
+        out += '-';
+        AppendTimetableID(out, params.View, timetable.Key);
+        out += '-';
+        AppendNumber(out, request.ID());
+        out += "@schedulega\r\nDTSTAMP:";
+        appendDateTime(params.FirstMonday, minutes{0});
+        out += "Z\r\nDTSTART:";
+        appendDateTime(date, begin);
+        out += "\r\nDTEND:";
+        appendDateTime(date, begin + params.LessonDuration);
+        out += "\r\nSUMMARY:Subject ";
+        AppendNumber(out, request.ID());
+        if(HasClassroom(classroom))
+        {
+            out += "\r\nLOCATION:Building ";
+            AppendNumber(out, classroom.Building);
+            out += ", classroom ";
+            AppendNumber(out, classroom.Classroom);
+        }
+
+        out += "\r\nCATEGORIES:";
+        out += ViewName(params.View);
+        out += ' ';
+        AppendTimetableID(out, params.View, timetable.Key);
+        out += "\r\nEND:VEVENT\r\n";
+    }
+}
+
+
+template<typename Calendar>
+void ExportSchedule(const BasicScheduleChromosomes<Calendar>& chromosomes,
+                    const BasicScheduleData<Calendar>& data,
+                    const ScheduleExportParams& params,
+                    std::ostream& os)
+{
+    const auto timetables = MakeTimetables(chromosomes, data, params.View);
+
+    auto render = [&](std::string& out, const ExportTimetable& timetable)
+    {
+        switch(params.Format)
+        {
+        case ScheduleExportFormat::Csv: AppendCsv(out, timetable, chromosomes, data, params); break;
+        case ScheduleExportFormat::Json: AppendJson(out, timetable, chromosomes, data, params); break;
+        case ScheduleExportFormat::ICalendar: AppendICalendarEvents(out, timetable, chromosomes, data, params); break;
+        }
+    };
+
+    BufferedWriter writer(os);
+    auto writeSeparator = [&](std::size_t index)
+    {
+        if(params.Format == ScheduleExportFormat::Json && index > 0)
+            writer.Write(",\n");
+    };
+
+    switch(params.Format)
+    {
+    case ScheduleExportFormat::Csv:
+        writer.Write(ViewName(params.View));
+        writer.Write(",day,lesson,subject,professor,building,classroom,groups\n");
+        break;
+    case ScheduleExportFormat::Json:
+        writer.Write("[");
+        break;
+    case ScheduleExportFormat::ICalendar:
+        writer.Write("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//ScheduleGA//Timetable//EN\r\n");
+        break;
+    }
+
+    if(timetables.size() >= params.ParallelTimetablesThreshold)
+    {
+        // timetables are rendered in parallel one chunk at a time and each chunk is written right away,
+        // so only a single chunk of text is held in memory
+        std::vector<std::string> rendered(std::min(timetables.size(), PARALLEL_EXPORT_CHUNK_SIZE));
+        for(std::size_t begin = 0; begin < timetables.size(); begin += rendered.size())
+        {
+            const std::size_t count = std::min(rendered.size(), timetables.size() - begin);
+            std::transform(std::execution::par,
+                           timetables.begin() + begin,
+                           timetables.begin() + begin + count,
+                           rendered.begin(),
+                           [&](const ExportTimetable& timetable)
+                           {
+                               std::string out;
+                               render(out, timetable);
+                               return out;
+                           });
+
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                writeSeparator(begin + i);
+                writer.Write(rendered[i]);
+            }
+        }
+    }
+    else
+    {
+        for(std::size_t i = 0; i < timetables.size(); ++i)
+        {
+            writeSeparator(i);
+            render(writer.Buffer(), timetables[i]);
+            writer.Commit();
+        }
+    }
+
+    switch(params.Format)
+    {
+    case ScheduleExportFormat::Csv:
+        break;
+    case ScheduleExportFormat::Json:
+        writer.Write("]\n");
+        break;
+    case ScheduleExportFormat::ICalendar:
+        writer.Write("END:VCALENDAR\r\n");
+        break;
+    }
+}
+
+
+#define INSTANTIATE_SCHEDULE_EXPORT(Calendar) \
+    template class BasicScheduleSlots<Calendar>; \
+    template void ExportSchedule(const BasicScheduleChromosomes<Calendar>&, const BasicScheduleData<Calendar>&, \
+                                 const ScheduleExportParams&, std::ostream&);
+
+INSTANTIATE_SCHEDULE_EXPORT(DefaultScheduleCalendar)
+INSTANTIATE_SCHEDULE_EXPORT(EightLessonsScheduleCalendar)
+INSTANTIATE_SCHEDULE_EXPORT(OneWeekScheduleCalendar)
@@ -0,0 +1,70 @@
+#pragma once
+#include "ScheduleCommon.h"
+#include "ScheduleChromosomes.h"
+
+#include <span>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+// Requests bucketed by lesson in one counting pass, requests of a lesson are in order of their indices
+template<typename Calendar>
+class BasicScheduleSlots
+{
+public:
+    explicit BasicScheduleSlots(const BasicScheduleChromosomes<Calendar>& chromosomes);
+
+    std::span<const std::size_t> Requests(std::size_t lesson) const
+    {
+        return std::span<const std::size_t>(requests_).subspan(offsets_[lesson], offsets_[lesson + 1] - offsets_[lesson]);
+    }
+
+private:
+    std::array<std::size_t, Calendar::MaxLessonsCount + 1> offsets_ = {};
+    std::vector<std::size_t> requests_;
+};
+
+using ScheduleSlots = BasicScheduleSlots<DefaultScheduleCalendar>;
+
+
+enum class ScheduleExportView
+{
+    Groups,
+    Professors,
+    Classrooms
+};
+
+enum class ScheduleExportFormat
+{
+    Csv,
+    Json,
+    ICalendar
+};
+
+struct ScheduleExportParams
+{
+    ScheduleExportView View = ScheduleExportView::Groups;
+    ScheduleExportFormat Format = ScheduleExportFormat::Csv;
+
+    // timetables are rendered in parallel when there are at least that many of them
+    std::size_t ParallelTimetablesThreshold = 256;
+
+    // iCalendar only: schedule lessons are placed to consecutive weeks starting from FirstMonday
+    std::chrono::year_month_day FirstMonday{std::chrono::year{2024}, std::chrono::September, std::chrono::day{2}};
+    std::chrono::minutes FirstLessonStart{8 * 60 + 30};
+    std::chrono::minutes LessonDuration{90};
+    std::chrono::minutes BreakDuration{10};
+};
+
+
+// Writes timetable of every group, professor or classroom of the view.
+// Timetables are ordered by their IDs, lessons of a timetable are ordered by time, not placed requests are skipped.
+// Lessons without a classroom have empty building and classroom in CSV, null in JSON and no LOCATION in iCalendar.
+// Output is streamed to os as timetables are rendered, the whole export is never held in memory.
+template<typename Calendar>
+void ExportSchedule(const BasicScheduleChromosomes<Calendar>& chromosomes,
+                    const BasicScheduleData<Calendar>& data,
+                    const ScheduleExportParams& params,
+                    std::ostream& os);
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+
+
+// Penalty weights of Evaluate terms, term with zero weight is disabled
+struct ScheduleFitnessWeights
+{
+    std::size_t GroupsLessonsGaps = 3;
+    std::size_t ProfessorsLessonsGaps = 2;
+    std::size_t DayComplexity = 4;
+    std::size_t BuildingsChanges = 64;
+    std::size_t NotPlacedLessons = 100;
+    std::size_t NotPlacedClassrooms = 100;
+
+    friend constexpr bool operator==(const ScheduleFitnessWeights&, const ScheduleFitnessWeights&) = default;
+};
+
+
+// Weights fixed at compile time: kernels of disabled terms are not compiled into the evaluation at all.
+// Policies other than the ones listed at the end of ScheduleChromosomes.cpp, ScheduleIndividual.cpp
+// and ScheduleGA.cpp must be instantiated there, like calendars.
+template<ScheduleFitnessWeights FixedWeights>
+struct StaticFitnessPolicy
+{
+    static constexpr bool IsStatic = true;
+    static constexpr ScheduleFitnessWeights Weights() { return FixedWeights; }
+};
+
+// Weights chosen at run time for tuning, disabled terms are skipped by choosing
+// the matching precompiled kernel on every evaluation
+struct RuntimeFitnessPolicy
+{
+    static constexpr bool IsStatic = false;
+    constexpr ScheduleFitnessWeights Weights() const { return Values; }
+
+    ScheduleFitnessWeights Values;
+};
+
+using DefaultFitnessPolicy = StaticFitnessPolicy<ScheduleFitnessWeights{}>;
+using NoBuildingsFitnessPolicy = StaticFitnessPolicy<ScheduleFitnessWeights{.BuildingsChanges = 0}>;
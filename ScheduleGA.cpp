@@ -5,14 +5,70 @@
 #include <exception>
 #include <execution>
 #include <algorithm>
+#include <numeric>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <limits>
+#include <cmath>
 
 
-ScheduleGA::ScheduleGA() : ScheduleGA(ScheduleGA::DefaultParams())
+static constexpr std::size_t TRACE_CHUNKS_PER_THREAD = 4;
+static constexpr std::size_t NOT_CROSSED = std::numeric_limits<std::size_t>::max();
+
+
+// Operator rate adjusted by the one-fifth success rule
+class AdaptiveRate
+{
+public:
+    static constexpr double TARGET_SUCCESS_RATIO = 0.2;
+    static constexpr double INCREASE_FACTOR = 1.1;
+    static constexpr double DECREASE_FACTOR = 0.9;
+
+    explicit AdaptiveRate(int initial, int min, int max)
+        : value_(std::clamp<double>(initial, min, max))
+        , min_(min)
+        , max_(max)
+    { }
+
+    int Value() const { return static_cast<int>(std::lround(value_)); }
+
+    void Update(std::size_t improvements, std::size_t applications)
+    {
+        if(applications == 0)
+            return;
+
+        const double successRatio = static_cast<double>(improvements) / static_cast<double>(applications);
+        value_ = std::clamp(value_ * (successRatio > TARGET_SUCCESS_RATIO ? INCREASE_FACTOR : DECREASE_FACTOR), min_, max_);
+    }
+
+private:
+    double value_;
+    double min_;
+    double max_;
+};
+
+
+template<typename Individual>
+static void FillKeys(const std::vector<Individual>& individuals, std::vector<ScheduleIndividualKey>& keys)
+{
+    keys.resize(individuals.size());
+    for(std::size_t i = 0; i < individuals.size(); ++i)
+        keys[i] = ScheduleIndividualKey{.Fitness = individuals[i].Evaluate(), .Index = i};
+}
+
+
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleGA<Calendar, FitnessPolicy>::BasicScheduleGA() : BasicScheduleGA(BasicScheduleGA::DefaultParams())
 {
 }
 
-ScheduleGA::ScheduleGA(const ScheduleGAParams& params)
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleGA<Calendar, FitnessPolicy>::BasicScheduleGA(const ScheduleGAParams& params,
+                                                          const FitnessPolicy& fitnessPolicy)
     : params_(params)
+    , fitnessPolicy_(fitnessPolicy)
     , individuals_()
 {
     if(params_.IndividualsCount <= 0)
@@ -21,17 +77,40 @@ ScheduleGA::ScheduleGA(const ScheduleGAParams& params)
     if(params_.IterationsCount < 0)
         throw std::invalid_argument("Invalid IterationsCount option: must be greater or equal to zero");
 
-    if(params_.SelectionCount < 0 || params_.SelectionCount >= params_.IndividualsCount)
-        throw std::invalid_argument("Invalid SelectionCount option: must be greater or equal to zero and less than IndividualsCount");
+    if(params_.SelectionCount <= 0 || params_.SelectionCount >= params_.IndividualsCount)
+        throw std::invalid_argument("Invalid SelectionCount option: must be greater than zero and less than IndividualsCount");
 
     if(params_.CrossoverCount < 0)
         throw std::invalid_argument("Invalid CrossoverCount option: must be greater or equal to zero");
 
     if(params_.MutationChance < 0 || params_.MutationChance > 100)
         throw std::invalid_argument("Invalid MutationChance option: must be in range [0, 100]");
+
+    if(params_.TournamentSize <= 0)
+        throw std::invalid_argument("Invalid TournamentSize option: must be greater than zero");
+
+    if(params_.ThreadsCount < 0)
+        throw std::invalid_argument("Invalid ThreadsCount option: must be greater or equal to zero");
+
+    if(params_.LocalSearchMoves < 0)
+        throw std::invalid_argument("Invalid LocalSearchMoves option: must be greater or equal to zero");
+
+    if(params_.MigrationInterval < 0)
+        throw std::invalid_argument("Invalid MigrationInterval option: must be greater or equal to zero");
+
+    if(params_.AdaptiveRates)
+    {
+        if(params_.MinMutationChance < 0 || params_.MinMutationChance > params_.MaxMutationChance || params_.MaxMutationChance > 100)
+            throw std::invalid_argument("Invalid MinMutationChance or MaxMutationChance options: must satisfy 0 <= MinMutationChance <= MaxMutationChance <= 100");
+
+        if(params_.MinCrossoverCount < 0 || params_.MaxCrossoverCount < 0 ||
+            params_.MinCrossoverCount > (params_.MaxCrossoverCount > 0 ? params_.MaxCrossoverCount : params_.IndividualsCount))
+            throw std::invalid_argument("Invalid MinCrossoverCount or MaxCrossoverCount options: must satisfy 0 <= MinCrossoverCount <= MaxCrossoverCount");
+    }
 }
 
-ScheduleGAParams ScheduleGA::DefaultParams()
+template<typename Calendar, typename FitnessPolicy>
+ScheduleGAParams BasicScheduleGA<Calendar, FitnessPolicy>::DefaultParams()
 {
     return ScheduleGAParams{
         .IndividualsCount = 1000,
@@ -42,56 +121,506 @@ ScheduleGAParams ScheduleGA::DefaultParams()
     };
 }
 
-ScheduleGAStatistics ScheduleGA::Start(const ScheduleData& scheduleData)
+template<typename Calendar>
+void BasicScheduleGARunState<Calendar>::Publish(const BasicScheduleChromosomes<Calendar>& chromosomes,
+                                                std::size_t fitness,
+                                                std::size_t iteration)
+{
+    auto current = best_.load(std::memory_order_acquire);
+    if(current != nullptr && current->Fitness <= fitness)
+        return;
+
+    auto candidate = std::make_shared<const Snapshot>(Snapshot{chromosomes, fitness, iteration});
+    while(current == nullptr || current->Fitness > fitness)
+    {
+        // concurrent publishers may race, the better snapshot always wins
+        if(best_.compare_exchange_weak(current, candidate, std::memory_order_acq_rel, std::memory_order_acquire))
+            return;
+    }
+}
+
+template<typename Calendar>
+void BasicScheduleGARunState<Calendar>::ReportProgress(const ScheduleGAProgress& progress) const
+{
+    if(onProgress_)
+        onProgress_(progress);
+}
+
+
+template<typename Calendar, typename FitnessPolicy>
+ScheduleGAStatistics BasicScheduleGA<Calendar, FitnessPolicy>::Start(const ScheduleData& scheduleData)
+{
+    BasicScheduleGARunState<Calendar> state;
+    return Run(scheduleData, state);
+}
+
+template<typename Calendar, typename FitnessPolicy>
+ScheduleGAStatistics BasicScheduleGA<Calendar, FitnessPolicy>::Start(const ScheduleData& scheduleData, BasicScheduleGARunState<Calendar>& state)
+{
+    return Run(scheduleData, state);
+}
+
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleGAHandle<Calendar> BasicScheduleGA<Calendar, FitnessPolicy>::StartAsync(const ScheduleData& scheduleData,
+                                                                      ScheduleGAProgressCallback onProgress)
+{
+    auto pState = std::make_shared<BasicScheduleGARunState<Calendar>>(std::move(onProgress));
+    auto result = std::async(std::launch::async, [this, &scheduleData, pState]
+    {
+        return Run(scheduleData, *pState);
+    });
+
+    return BasicScheduleGAHandle<Calendar>(std::move(result), std::move(pState));
+}
+
+template<typename Calendar, typename FitnessPolicy>
+ScheduleGAStatistics BasicScheduleGA<Calendar, FitnessPolicy>::Run(const ScheduleData& scheduleData, BasicScheduleGARunState<Calendar>& state)
+{
+    const std::size_t individualsCount = IndividualsCountInBudget(scheduleData);
+
+    pRunState_ = &state;
+    const ScheduleTraceScope startScope(pTracer_, "ScheduleGA::Start");
+
+    std::mt19937 seedGen(params_.Seed != 0 ? params_.Seed : std::random_device{}());
+    InitPopulation(scheduleData, individualsCount, seedGen);
+
+    const auto& firstBest = *std::ranges::min_element(individuals_, ScheduleIndividualLess());
+    state.Publish(firstBest.Chromosomes(), firstBest.Evaluate(), 0);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    const auto beginCounters = CollectScheduleCounters();
+
+    ScheduleGAStatistics result{};
+    result.MutationChance = params_.MutationChance;
+    result.CrossoverCount = params_.CrossoverCount;
+    if(params_.Mode == ScheduleGAMode::SteadyState)
+    {
+        StartSteadyState(result, seedGen);
+    }
+    else
+    {
+        std::mt19937 randGen(seedGen());
+        StartGenerational(result, randGen);
+    }
+
+    // individuals are moved once into the order of sorted keys
+    std::vector<ScheduleIndividualKey> keys;
+    FillKeys(individuals_, keys);
+    std::ranges::sort(keys);
+
+    std::vector<ScheduleIndividual> sortedIndividuals;
+    sortedIndividuals.reserve(individuals_.size());
+    for(const auto& key : keys)
+        sortedIndividuals.emplace_back(std::move(individuals_[key.Index]));
+
+    individuals_.swap(sortedIndividuals);
+    result.BestEvaluation = EvaluateDetailed(individuals_.front().Chromosomes(), scheduleData, fitnessPolicy_);
+    result.Time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginTime);
+    std::ranges::transform(CollectScheduleCounters(), beginCounters, result.Counters.begin(), std::minus<>{});
+    result.Memory = ProjectMemory(scheduleData, individualsCount);
+    if(result.Time.count() > 0)
+        result.EvaluationsPerSecond = static_cast<double>(result.EvaluationsCount) * 1000.0 / static_cast<double>(result.Time.count());
+
+    pRunState_ = nullptr;
+    return result;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleGA<Calendar, FitnessPolicy>::InitPopulation(const ScheduleData& scheduleData,
+                                                              std::size_t individualsCount,
+                                                              std::mt19937& seedGen)
 {
-    std::random_device randomDevice;
-    const ScheduleIndividual firstIndividual(randomDevice, &scheduleData);
+    const ScheduleTraceScope initScope(pTracer_, "initialize");
+    ScheduleIndividual firstIndividual(seedGen, &scheduleData, BasicScheduleChromosomes<Calendar>(scheduleData), fitnessPolicy_);
+    if(params_.RepairIndividuals)
+        firstIndividual.Repair();
+
     firstIndividual.Evaluate();
 
+    // seeds are drawn up front because seed generator is not shared between threads
+    std::vector<std::mt19937::result_type> seeds(individualsCount);
+    std::ranges::generate(seeds, std::ref(seedGen));
+
     individuals_.clear();
-    individuals_.resize(params_.IndividualsCount, firstIndividual);
+    individuals_.resize(individualsCount, firstIndividual);
+    if(params_.Initialization == ScheduleGAInitialization::Greedy)
+    {
+        // copy construction copies random generator of the first individual as well
+        for(std::size_t i = 0; i < individuals_.size(); ++i)
+            individuals_[i].Reseed(seeds[i]);
+
+        return;
+    }
+
+    // individuals are replaced by move assignment, which takes their own random generators;
+    // evaluations of the initial population are not counted in statistics as before
+    TransformSum(individuals_.begin(), individuals_.end(), [&](ScheduleIndividual& individual)
+    {
+        std::mt19937 randGen(seeds[&individual - individuals_.data()]);
+        individual = ScheduleIndividual(randGen, &scheduleData, BasicScheduleChromosomes<Calendar>(scheduleData, randGen), fitnessPolicy_);
+        if(params_.RepairIndividuals)
+            individual.Repair();
+
+        individual.Evaluate();
+        return std::size_t{0};
+    }, "build individual");
+}
 
-    std::mt19937 randGen(randomDevice());
+template<typename Calendar, typename FitnessPolicy>
+ScheduleMemoryReport BasicScheduleGA<Calendar, FitnessPolicy>::ProjectMemory(const ScheduleData& scheduleData, std::size_t individualsCount) const
+{
+    const std::size_t requestsCount = scheduleData.SubjectRequests().size();
+    const std::size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    ScheduleMemoryReport report;
+    report.IndividualsCount = individualsCount;
+    report.IndividualBytes = sizeof(ScheduleIndividual) + requestsCount * (sizeof(std::size_t) + sizeof(ClassroomAddress));
+    report.PopulationBytes = individualsCount * report.IndividualBytes;
+    report.ScheduleDataBytes = scheduleData.MemoryUsage();
+    report.ScratchBytesPerThread = EvaluationScratchMemoryUsage(scheduleData);
+
+    if(params_.LocalSearchMoves > 0)
+    {
+        report.ScratchBytesPerThread += sizeof(IncrementalEvaluator<Calendar, FitnessPolicy>) +
+            scheduleData.ProfessorsRequests().size() * sizeof(std::size_t) +
+            scheduleData.GroupsRequests().size() * sizeof(GroupEvaluation);
+    }
+
+    if(params_.Mode == ScheduleGAMode::SteadyState)
+    {
+        // every worker breeds a child from a copy of its mate
+        report.ScratchBytesPerThread += 2 * report.IndividualBytes;
+        report.ThreadsCount = params_.ThreadsCount > 0 ? params_.ThreadsCount : hardwareThreads;
+    }
+    else
+    {
+        report.ThreadsCount = hardwareThreads;
+    }
 
-    std::uniform_int_distribution<std::size_t> selectionBestDist(0, params_.SelectionCount - 1);
+    if(params_.SingleThreaded)
+        report.ThreadsCount = 1;
+
+    return report;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+std::size_t BasicScheduleGA<Calendar, FitnessPolicy>::IndividualsCountInBudget(const ScheduleData& scheduleData) const
+{
+    const ScheduleMemoryReport report = ProjectMemory(scheduleData, params_.IndividualsCount);
+    if(params_.MemoryBudget == 0 || report.TotalBytes() <= params_.MemoryBudget)
+        return params_.IndividualsCount;
+
+    const std::string projection = "projected memory " + std::to_string(report.TotalBytes()) +
+        " bytes exceeds MemoryBudget of " + std::to_string(params_.MemoryBudget) + " bytes";
+
+    if(!params_.ShrinkPopulationToBudget)
+        throw std::runtime_error("Unable to start: " + projection);
+
+    const std::size_t fixedBytes = report.TotalBytes() - report.PopulationBytes;
+    const std::size_t individualsCount = fixedBytes < params_.MemoryBudget ? (params_.MemoryBudget - fixedBytes) / report.IndividualBytes : 0;
+    if(individualsCount <= static_cast<std::size_t>(params_.SelectionCount))
+        throw std::runtime_error("Unable to shrink population to more than SelectionCount individuals: " + projection);
+
+    return individualsCount;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleGA<Calendar, FitnessPolicy>::StartGenerational(ScheduleGAStatistics& statistics, std::mt19937& randGen)
+{
+    // options are validated to be non-negative, so they are converted once here
+    const std::size_t selectionCount = static_cast<std::size_t>(params_.SelectionCount);
+    const std::size_t iterationsCount = static_cast<std::size_t>(params_.IterationsCount);
+
+    std::uniform_int_distribution<std::size_t> selectionBestDist(0, selectionCount - 1);
     std::uniform_int_distribution<std::size_t> individualsDist(0, individuals_.size() - 1);
 
-    const auto beginTime = std::chrono::steady_clock::now();
+    // fixed rates are kept by bounds equal to the initial values
+    const int maxCrossoverCount = params_.MaxCrossoverCount > 0 ? params_.MaxCrossoverCount : params_.IndividualsCount;
+    AdaptiveRate mutationChance = params_.AdaptiveRates
+        ? AdaptiveRate(params_.MutationChance, params_.MinMutationChance, params_.MaxMutationChance)
+        : AdaptiveRate(params_.MutationChance, params_.MutationChance, params_.MutationChance);
+    AdaptiveRate crossoverCount = params_.AdaptiveRates
+        ? AdaptiveRate(params_.CrossoverCount, params_.MinCrossoverCount, maxCrossoverCount)
+        : AdaptiveRate(params_.CrossoverCount, params_.CrossoverCount, params_.CrossoverCount);
 
-    ScheduleGAStatistics result{};
-    for(std::size_t iteration = 0; iteration < params_.IterationsCount; ++iteration)
+    std::vector<std::size_t> fitnessBeforeCrossover;
+    if(params_.AdaptiveRates)
+        fitnessBeforeCrossover.resize(individuals_.size());
+
+    // indexes of SelectionCount best individuals after mutation
+    std::vector<std::size_t> selected(selectionCount);
+    std::vector<ScheduleIndividualKey> keys;
+    const std::size_t survivorsCount = individuals_.size() - selectionCount;
+
+    std::chrono::steady_clock::duration localSearchTime{0};
+    for(std::size_t iteration = 0; iteration < iterationsCount && !pRunState_->StopRequested(); ++iteration)
     {
+        const ScheduleTraceScope generationScope(pTracer_, "generation");
+        statistics.MutationChance = mutationChance.Value();
+        statistics.CrossoverCount = crossoverCount.Value();
+
         // mutate
-        std::for_each(std::execution::par_unseq, individuals_.begin(), individuals_.end(), 
-                      ScheduleIndividualMutator(params_.MutationChance));
+        std::atomic<std::size_t> mutationImprovements = 0;
+        const std::size_t mutationsCount = TransformSum(individuals_.begin(), individuals_.end(),
+                                                        [&, mutator = ScheduleIndividualMutator(statistics.MutationChance, params_.RepairIndividuals)](ScheduleIndividual& individual)
+        {
+            // individuals are evaluated after previous generation, so fitness before mutation is cached
+            const std::size_t fitnessBefore = individual.Evaluate();
+            const std::size_t evaluations = mutator(individual);
+            if(evaluations > 0 && individual.Evaluate() < fitnessBefore)
+                mutationImprovements.fetch_add(1, std::memory_order_relaxed);
+
+            return evaluations;
+        }, "mutate");
+
+        statistics.EvaluationsCount += mutationsCount;
 
         // select best
-        std::ranges::nth_element(individuals_, individuals_.begin() + params_.SelectionCount, ScheduleIndividualLess());
+        {
+            const ScheduleTraceScope selectScope(pTracer_, "select");
+            FillKeys(individuals_, keys);
+            std::ranges::nth_element(keys, keys.begin() + selectionCount);
+            std::ranges::transform(keys.begin(), keys.begin() + selectionCount, selected.begin(), &ScheduleIndividualKey::Index);
+        }
+
+        // improve best
+        if(params_.LocalSearchMoves > 0)
+        {
+            const auto localSearchBegin = std::chrono::steady_clock::now();
+            statistics.LocalSearchImprovementsCount += TransformSum(selected.begin(), selected.end(), [&](std::size_t i)
+            {
+                return individuals_[i].LocalSearch(params_.LocalSearchMoves);
+            }, "local search");
+
+            statistics.LocalSearchMovesCount += selectionCount * params_.LocalSearchMoves;
+            localSearchTime += std::chrono::steady_clock::now() - localSearchBegin;
+        }
 
         //std::cout << "Iteration: " << iteration << "; Best: " << std::min_element(individuals_.begin(), individuals_.begin() + SelectionCount(), ScheduleIndividualLess())->Evaluate() << '\n';
 
         // crossover
-        for(std::size_t i = 0; i < params_.CrossoverCount; ++i)
         {
-            ScheduleIndividual& firstInd = individuals_.at(selectionBestDist(randGen));
-            ScheduleIndividual& secondInd = individuals_.at(individualsDist(randGen));
-            firstInd.Crossover(secondInd);
+            const ScheduleTraceScope crossoverScope(pTracer_, "crossover");
+            std::ranges::fill(fitnessBeforeCrossover, NOT_CROSSED);
+            for(int i = 0; i < statistics.CrossoverCount; ++i)
+            {
+                const std::size_t first = selected[selectionBestDist(randGen)];
+                const std::size_t second = individualsDist(randGen);
+                const std::size_t firstFitness = individuals_[first].Evaluated() ? individuals_[first].Evaluate() : NOT_CROSSED;
+                const std::size_t secondFitness = individuals_[second].Evaluated() ? individuals_[second].Evaluate() : NOT_CROSSED;
+                if(individuals_[first].Crossover(individuals_[second]) && params_.AdaptiveRates)
+                {
+                    // keep fitness from before the first crossover of the generation
+                    fitnessBeforeCrossover[first] = std::min(fitnessBeforeCrossover[first], firstFitness);
+                    fitnessBeforeCrossover[second] = std::min(fitnessBeforeCrossover[second], secondFitness);
+                }
+            }
         }
 
-        std::for_each(std::execution::par_unseq, individuals_.begin(), individuals_.end(), ScheduleIndividualEvaluator());
+        statistics.EvaluationsCount += TransformSum(individuals_.begin(), individuals_.end(),
+                                                    ScheduleIndividualEvaluator(), "evaluate");
+
+        if(params_.AdaptiveRates)
+        {
+            std::size_t crossoverImprovements = 0;
+            for(std::size_t i = 0; i < individuals_.size(); ++i)
+                crossoverImprovements += (fitnessBeforeCrossover[i] != NOT_CROSSED && individuals_[i].Evaluate() < fitnessBeforeCrossover[i]);
+
+            mutationChance.Update(mutationImprovements.load(std::memory_order_relaxed), mutationsCount);
+            // both parents of every attempted crossover are candidates for improvement
+            crossoverCount.Update(crossoverImprovements, 2 * static_cast<std::size_t>(statistics.CrossoverCount));
+        }
 
         // natural selection
-        std::ranges::nth_element(individuals_, individuals_.end() - params_.SelectionCount, ScheduleIndividualLess());
-        std::copy_n(individuals_.begin(), params_.SelectionCount, individuals_.end() - params_.SelectionCount);
+        {
+            const ScheduleTraceScope naturalSelectionScope(pTracer_, "natural selection");
+            // worst SelectionCount keys go to the end and are replaced by copies of the best ones
+            const std::size_t sourcesCount = std::min(selectionCount, survivorsCount);
+            FillKeys(individuals_, keys);
+            std::ranges::nth_element(keys, keys.begin() + survivorsCount);
+            if(sourcesCount < survivorsCount)
+                std::nth_element(keys.begin(), keys.begin() + sourcesCount, keys.begin() + survivorsCount);
+
+            for(std::size_t i = 0; i < selectionCount; ++i)
+                individuals_[keys[survivorsCount + i].Index] = individuals_[keys[i % sourcesCount].Index];
+        }
+
+        const auto& best = individuals_[std::min_element(keys.begin(), keys.begin() + survivorsCount)->Index];
+        pRunState_->Publish(best.Chromosomes(), best.Evaluate(), iteration + 1);
+        pRunState_->ReportProgress(ScheduleGAProgress{
+            .Iteration = iteration + 1,
+            .BestFitness = best.Evaluate(),
+            .EvaluationsCount = statistics.EvaluationsCount
+        });
+
+        if(pMigration_ != nullptr && params_.MigrationInterval > 0 && (iteration + 1) % params_.MigrationInterval == 0)
+            Migrate(keys, randGen);
     }
 
-    std::ranges::sort(individuals_, ScheduleIndividualLess());
-    result.Time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginTime);
-    return result;
+    statistics.LocalSearchTime = std::chrono::duration_cast<std::chrono::milliseconds>(localSearchTime);
 }
 
-const std::vector<ScheduleIndividual>& ScheduleGA::Individuals() const
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleGA<Calendar, FitnessPolicy>::StartSteadyState(ScheduleGAStatistics& statistics, std::mt19937& seedGen)
+{
+    const std::size_t offspringCount = static_cast<std::size_t>(params_.IterationsCount) * individuals_.size();
+    std::size_t threadsCount = params_.ThreadsCount > 0 ? params_.ThreadsCount : std::max(std::thread::hardware_concurrency(), 1u);
+    if(params_.SingleThreaded)
+        threadsCount = 1;
+
+    // fitness values are read by tournaments without locking, individuals are copied and replaced under per-slot locks
+    std::vector<std::atomic<std::size_t>> fitness(individuals_.size());
+    for(std::size_t i = 0; i < individuals_.size(); ++i)
+        fitness[i].store(individuals_[i].Evaluate(), std::memory_order_relaxed);
+
+    std::vector<std::mutex> locks(individuals_.size());
+    std::atomic<std::size_t> producedOffspring = 0;
+    std::atomic<std::size_t> bestFitness = pRunState_->Best()->Fitness;
+    const std::size_t mutationChance = static_cast<std::size_t>(params_.MutationChance);
+
+    auto worker = [&](std::mt19937::result_type seed)
+    {
+        const ScheduleTraceScope workerScope(pTracer_, "steady-state worker");
+        std::mt19937 randGen(seed);
+        std::uniform_int_distribution<std::size_t> individualsDist(0, individuals_.size() - 1);
+        std::uniform_int_distribution<std::size_t> mutationDist(0, 100);
+
+        auto tournament = [&](auto better)
+        {
+            std::size_t winner = individualsDist(randGen);
+            for(int i = 1; i < params_.TournamentSize; ++i)
+            {
+                const std::size_t candidate = individualsDist(randGen);
+                if(better(fitness[candidate].load(std::memory_order_relaxed), fitness[winner].load(std::memory_order_relaxed)))
+                    winner = candidate;
+            }
+
+            return winner;
+        };
+
+        auto copyOf = [&](std::size_t i)
+        {
+            std::lock_guard lock(locks[i]);
+            return individuals_[i];
+        };
+
+        std::size_t offspring = 0;
+        while(!pRunState_->StopRequested() && (offspring = producedOffspring.fetch_add(1, std::memory_order_relaxed)) < offspringCount)
+        {
+            ScheduleIndividual child = copyOf(tournament(std::less<>{}));
+            ScheduleIndividual mate = copyOf(tournament(std::less<>{}));
+            child.Reseed(randGen());
+
+            child.Crossover(mate);
+            if(mutationDist(randGen) <= mutationChance)
+                child.Mutate();
+
+            if(params_.RepairIndividuals)
+                child.Repair();
+
+            const std::size_t childFitness = child.Evaluate();
+            const std::size_t iteration = offspring / individuals_.size() + 1;
+            std::size_t knownBest = bestFitness.load(std::memory_order_relaxed);
+            while(childFitness < knownBest && !bestFitness.compare_exchange_weak(knownBest, childFitness, std::memory_order_relaxed));
+            if(childFitness < knownBest)
+                pRunState_->Publish(child.Chromosomes(), childFitness, iteration);
+
+            // thread which produced the last offspring of an iteration reports it
+            if((offspring + 1) % individuals_.size() == 0)
+            {
+                pRunState_->ReportProgress(ScheduleGAProgress{
+                    .Iteration = iteration,
+                    .BestFitness = pRunState_->Best()->Fitness,
+                    .EvaluationsCount = offspring + 1
+                });
+            }
+
+            const std::size_t loser = tournament(std::greater<>{});
+            std::lock_guard lock(locks[loser]);
+            if(childFitness <= fitness[loser].load(std::memory_order_relaxed))
+            {
+                individuals_[loser] = std::move(child);
+                fitness[loser].store(childFitness, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    if(threadsCount == 1)
+    {
+        worker(seedGen());
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount);
+        for(std::size_t t = 0; t < threadsCount; ++t)
+            threads.emplace_back(worker, seedGen());
+
+        for(auto& thread : threads)
+            thread.join();
+    }
+
+    statistics.EvaluationsCount += std::min(producedOffspring.load(), offspringCount);
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleGA<Calendar, FitnessPolicy>::Migrate(const std::vector<ScheduleIndividualKey>& keys, std::mt19937& randGen)
+{
+    const auto& best = individuals_[std::ranges::min_element(keys)->Index];
+    pMigration_->Emigrate(best.Chromosomes(), best.Evaluate());
+
+    // last SelectionCount keys point to copies of the best individuals after natural selection
+    auto immigrants = pMigration_->Immigrate();
+    const std::size_t immigrantsCount = std::min(immigrants.size(), individuals_.size());
+
+    const ScheduleData& scheduleData = best.Data();
+    for(std::size_t i = 0; i < immigrantsCount; ++i)
+    {
+        auto& replaced = individuals_[keys[keys.size() - 1 - i].Index];
+        replaced = ScheduleIndividual(randGen, &scheduleData, std::move(immigrants[i]), fitnessPolicy_);
+        replaced.Evaluate();
+    }
+}
+
+template<typename Calendar, typename FitnessPolicy>
+template<typename Iterator, typename UnaryOp>
+std::size_t BasicScheduleGA<Calendar, FitnessPolicy>::TransformSum(Iterator first, Iterator last, UnaryOp op, const char* phaseName) const
+{
+    if(params_.SingleThreaded)
+    {
+        const ScheduleTraceScope phaseScope(pTracer_, phaseName);
+        return std::transform_reduce(first, last, std::size_t{0}, std::plus<>{}, op);
+    }
+
+    if(pTracer_ == nullptr)
+        return std::transform_reduce(std::execution::par_unseq, first, last, std::size_t{0}, std::plus<>{}, op);
+
+    // traced runs split the range into chunks, so that every worker thread records when it processed its part
+    const std::size_t size = std::distance(first, last);
+    const std::size_t chunksCount = std::min<std::size_t>(size, TRACE_CHUNKS_PER_THREAD * std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<std::size_t> chunks(chunksCount);
+    std::iota(chunks.begin(), chunks.end(), std::size_t{0});
+
+    return std::transform_reduce(std::execution::par, chunks.begin(), chunks.end(), std::size_t{0}, std::plus<>{}, [&](std::size_t chunk)
+    {
+        const ScheduleTraceScope chunkScope(pTracer_, phaseName);
+        return std::transform_reduce(first + chunk * size / chunksCount, first + (chunk + 1) * size / chunksCount,
+                                     std::size_t{0}, std::plus<>{}, op);
+    });
+}
+
+template<typename Calendar, typename FitnessPolicy>
+const std::vector<typename BasicScheduleGA<Calendar, FitnessPolicy>::ScheduleIndividual>& BasicScheduleGA<Calendar, FitnessPolicy>::Individuals() const
 {
     assert(std::ranges::is_sorted(individuals_, ScheduleIndividualLess()));
     return individuals_;
 }
+
+
+template class BasicScheduleGA<DefaultScheduleCalendar>;
+template class BasicScheduleGA<EightLessonsScheduleCalendar>;
+template class BasicScheduleGA<OneWeekScheduleCalendar>;
+template class BasicScheduleGA<DefaultScheduleCalendar, RuntimeFitnessPolicy>;
+template class BasicScheduleGA<EightLessonsScheduleCalendar, RuntimeFitnessPolicy>;
+template class BasicScheduleGA<OneWeekScheduleCalendar, RuntimeFitnessPolicy>;
+template class BasicScheduleGA<DefaultScheduleCalendar, NoBuildingsFitnessPolicy>;
@@ -1,14 +1,70 @@
 #pragma once
 #include "ScheduleCommon.h"
 #include "ScheduleIndividual.h"
+#include "ScheduleCounters.h"
+#include "ScheduleTrace.h"
 
 #include <vector>
 #include <chrono>
+#include <random>
+#include <atomic>
+#include <memory>
+#include <future>
+#include <functional>
+
+
+struct ScheduleMemoryReport
+{
+    std::size_t IndividualsCount = 0;
+    // individual object with its chromosomes, random generator state is stored inline
+    std::size_t IndividualBytes = 0;
+    std::size_t PopulationBytes = 0;
+    // requests, conflict graph and precomputed indexes
+    std::size_t ScheduleDataBytes = 0;
+    // peak temporary buffers of one solver thread: evaluation, local search evaluator, steady-state offspring
+    std::size_t ScratchBytesPerThread = 0;
+    std::size_t ThreadsCount = 0;
+
+    std::size_t TotalBytes() const { return PopulationBytes + ScheduleDataBytes + ScratchBytesPerThread * ThreadsCount; }
+};
 
 
 struct ScheduleGAStatistics
 {
    std::chrono::milliseconds Time;
+   std::size_t EvaluationsCount = 0;
+   double EvaluationsPerSecond = 0.0;
+   std::chrono::milliseconds LocalSearchTime{0};
+   std::size_t LocalSearchMovesCount = 0;
+   std::size_t LocalSearchImprovementsCount = 0;
+   // operators counters collected during the run, zeros unless built with SCHEDULE_GA_COUNTERS;
+   // counters are process-wide, so runs executed concurrently see each other's events
+   ScheduleCountersValues Counters = {};
+   ScheduleMemoryReport Memory;
+   // rates used in the last generation, differ from params only with AdaptiveRates
+   int MutationChance = 0;
+   int CrossoverCount = 0;
+   // terms of the best individual at the end of the run
+   ScheduleEvaluation BestEvaluation;
+};
+
+
+enum class ScheduleGAMode
+{
+    // whole population is mutated, crossed over and selected every iteration
+    Generational,
+    // worker threads breed offspring from tournaments and replace tournament losers,
+    // every iteration produces IndividualsCount offspring
+    SteadyState
+};
+
+
+enum class ScheduleGAInitialization
+{
+    // every individual starts as a copy of one greedy schedule
+    Greedy,
+    // every individual is built concurrently by randomized DSatur coloring of the requests conflict graph
+    GraphColoring
 };
 
 
@@ -19,22 +75,193 @@ struct ScheduleGAParams
     int SelectionCount = 0;
     int CrossoverCount = 0;
     int MutationChance = 0;
+    ScheduleGAMode Mode = ScheduleGAMode::Generational;
+    int TournamentSize = 4;
+    // steady-state workers count, zero uses hardware concurrency. Generational phases run on the default
+    // parallel algorithms pool and ignore it, cap that pool by the caller as bench_ScheduleGA does with TBB
+    int ThreadsCount = 0;
+    // local search moves tried per each of SelectionCount best individuals every generation, zero disables local search
+    int LocalSearchMoves = 0;
+    // generations between exchanges with the migration channel, zero disables migration
+    int MigrationInterval = 0;
+    // runs the whole algorithm in the calling thread, used for small problems solved in batches
+    bool SingleThreaded = false;
+    // limit of projected memory footprint in bytes, zero means unlimited
+    std::size_t MemoryBudget = 0;
+    // if projected footprint exceeds MemoryBudget population is shrunk to fit instead of refusing to start
+    bool ShrinkPopulationToBudget = false;
+    // generational mode adjusts MutationChance and CrossoverCount after every generation:
+    // rate grows while more than a fifth of operator applications improve fitness and shrinks otherwise
+    bool AdaptiveRates = false;
+    int MinMutationChance = 1;
+    int MaxMutationChance = 100;
+    int MinCrossoverCount = 1;
+    // zero means IndividualsCount
+    int MaxCrossoverCount = 0;
+    ScheduleGAInitialization Initialization = ScheduleGAInitialization::Greedy;
+    // initial, mutated and steady-state offspring individuals get their not placed requests repaired
+    bool RepairIndividuals = false;
+    // seeds random generators of the run including immigrants, zero draws the seed from std::random_device;
+    // runs with the same seed start from the same population, parallel phases may still diverge later
+    std::mt19937::result_type Seed = 0;
+};
+
+
+// Channel for exchanging individuals between independent populations (islands)
+template<typename Calendar>
+class BasicScheduleGAMigration
+{
+public:
+    virtual ~BasicScheduleGAMigration() = default;
+
+    virtual void Emigrate(const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t fitness) = 0;
+    virtual std::vector<BasicScheduleChromosomes<Calendar>> Immigrate() = 0;
+};
+
+
+struct ScheduleGAProgress
+{
+    std::size_t Iteration = 0;
+    std::size_t BestFitness = 0;
+    std::size_t EvaluationsCount = 0;
+};
+
+using ScheduleGAProgressCallback = std::function<void(const ScheduleGAProgress&)>;
+
+
+// Fitness and position of an individual, selection reorders these keys instead of individuals
+struct ScheduleIndividualKey
+{
+    std::size_t Fitness = 0;
+    std::size_t Index = 0;
+
+    friend auto operator<=>(const ScheduleIndividualKey&, const ScheduleIndividualKey&) = default;
+};
+
+
+template<typename Calendar>
+struct BasicScheduleGASnapshot
+{
+    BasicScheduleChromosomes<Calendar> Chromosomes;
+    std::size_t Fitness = 0;
+    std::size_t Iteration = 0;
 };
 
 
-class ScheduleGA
+// State shared between a running algorithm and its observers
+template<typename Calendar>
+class BasicScheduleGARunState
 {
 public:
-    ScheduleGA();
-    explicit ScheduleGA(const ScheduleGAParams& params);
+    using Snapshot = BasicScheduleGASnapshot<Calendar>;
+
+    explicit BasicScheduleGARunState(ScheduleGAProgressCallback onProgress = {})
+        : onProgress_(std::move(onProgress))
+    { }
+
+    // never waits for the solver, returns nullptr until the first individual is evaluated
+    std::shared_ptr<const Snapshot> Best() const { return best_.load(std::memory_order_acquire); }
+
+    // replaces current best if the new one is strictly better, copies chromosomes only in that case
+    void Publish(const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t fitness, std::size_t iteration);
+    void ReportProgress(const ScheduleGAProgress& progress) const;
+
+    void RequestStop() { stopRequested_.store(true, std::memory_order_relaxed); }
+    bool StopRequested() const { return stopRequested_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::shared_ptr<const Snapshot>> best_;
+    std::atomic<bool> stopRequested_ = false;
+    ScheduleGAProgressCallback onProgress_;
+};
+
+
+template<typename Calendar>
+class BasicScheduleGAHandle
+{
+public:
+    using Snapshot = BasicScheduleGASnapshot<Calendar>;
+
+    explicit BasicScheduleGAHandle(std::future<ScheduleGAStatistics> result,
+                                   std::shared_ptr<BasicScheduleGARunState<Calendar>> pState)
+        : result_(std::move(result))
+        , pState_(std::move(pState))
+    { }
+
+    // best individual found so far, may be read while algorithm is running
+    std::shared_ptr<const Snapshot> Best() const { return pState_->Best(); }
+
+    // finishes the run after current iteration, individuals found so far are kept
+    void Stop() { pState_->RequestStop(); }
+
+    bool Ready() const { return result_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+    void Wait() const { result_.wait(); }
+
+    // waits for the algorithm and rethrows its exception if any, may be called once
+    ScheduleGAStatistics Get() { return result_.get(); }
+
+private:
+    std::future<ScheduleGAStatistics> result_;
+    std::shared_ptr<BasicScheduleGARunState<Calendar>> pState_;
+};
+
+
+template<typename Calendar, typename FitnessPolicy = DefaultFitnessPolicy>
+class BasicScheduleGA
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+    using ScheduleIndividual = BasicScheduleIndividual<Calendar, FitnessPolicy>;
+
+    BasicScheduleGA();
+    explicit BasicScheduleGA(const ScheduleGAParams& params,
+                             const FitnessPolicy& fitnessPolicy = {});
 
     static ScheduleGAParams DefaultParams();
     const ScheduleGAParams& Params() const { return params_; }
 
     ScheduleGAStatistics Start(const ScheduleData& scheduleData);
+    // runs on the calling thread, state may be observed and stopped from other threads meanwhile
+    ScheduleGAStatistics Start(const ScheduleData& scheduleData, BasicScheduleGARunState<Calendar>& state);
+
+    // runs Start in a separate thread, onProgress is called after every iteration from solver threads
+    // (in steady-state mode possibly concurrently from different workers);
+    // algorithm and scheduleData must outlive the run, Individuals() is valid after the handle is ready
+    BasicScheduleGAHandle<Calendar> StartAsync(const ScheduleData& scheduleData,
+                                               ScheduleGAProgressCallback onProgress = {});
+
     const std::vector<ScheduleIndividual>& Individuals() const;
 
+    // memory footprint of a run with given population size
+    ScheduleMemoryReport ProjectMemory(const ScheduleData& scheduleData, std::size_t individualsCount) const;
+
+    // generational mode sends its best individual every MigrationInterval generations
+    // and puts received individuals in place of the worst ones
+    void SetMigration(BasicScheduleGAMigration<Calendar>* pMigration) { pMigration_ = pMigration; }
+
+    // records phases of every generation, parallel phases are recorded per chunk on worker threads
+    void SetTracer(ScheduleTracer* pTracer) { pTracer_ = pTracer; }
+
+private:
+    ScheduleGAStatistics Run(const ScheduleData& scheduleData, BasicScheduleGARunState<Calendar>& state);
+    std::size_t IndividualsCountInBudget(const ScheduleData& scheduleData) const;
+    void InitPopulation(const ScheduleData& scheduleData, std::size_t individualsCount, std::mt19937& seedGen);
+    void StartGenerational(ScheduleGAStatistics& statistics, std::mt19937& randGen);
+    void StartSteadyState(ScheduleGAStatistics& statistics, std::mt19937& seedGen);
+    void Migrate(const std::vector<ScheduleIndividualKey>& keys, std::mt19937& randGen);
+
+    template<typename Iterator, typename UnaryOp>
+    std::size_t TransformSum(Iterator first, Iterator last, UnaryOp op, const char* phaseName) const;
+
 private:
     ScheduleGAParams params_;
+    [[no_unique_address]] FitnessPolicy fitnessPolicy_;
     std::vector<ScheduleIndividual> individuals_;
+    BasicScheduleGAMigration<Calendar>* pMigration_ = nullptr;
+    BasicScheduleGARunState<Calendar>* pRunState_ = nullptr;
+    ScheduleTracer* pTracer_ = nullptr;
 };
+
+using ScheduleGA = BasicScheduleGA<DefaultScheduleCalendar>;
+using ScheduleGAHandle = BasicScheduleGAHandle<DefaultScheduleCalendar>;
+using ScheduleGASnapshot = BasicScheduleGASnapshot<DefaultScheduleCalendar>;
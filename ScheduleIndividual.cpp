@@ -1,9 +1,13 @@
 #include "ScheduleIndividual.h"
 #include "LinearAllocator.h"
+#include "ScheduleCounters.h"
+#include "ScheduleExport.h"
 #include "utils.h"
 
 #include <array>
 #include <cassert>
+#include <string>
+#include <optional>
 #include <iostream>
 
 
@@ -11,9 +15,12 @@ static constexpr std::size_t DEFAULT_BUFFER_SIZE = 1024;
 static constexpr std::size_t NOT_EVALUATED = std::numeric_limits<std::size_t>::max();
 
 
-ScheduleIndividual::ScheduleIndividual(std::random_device& randomDevice,
-                                       const ScheduleData* pData)
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>::BasicScheduleIndividual(std::random_device& randomDevice,
+                                                                          const ScheduleData* pData,
+                                                                          const FitnessPolicy& fitnessPolicy)
     : pData_(pData)
+    , fitnessPolicy_(fitnessPolicy)
     , evaluatedValue_(NOT_EVALUATED)
     , chromosomes_(*pData)
     , randomGenerator_(randomDevice())
@@ -21,86 +28,214 @@ ScheduleIndividual::ScheduleIndividual(std::random_device& randomDevice,
     assert(pData != nullptr);
 }
 
-void ScheduleIndividual::swap(ScheduleIndividual& other) noexcept
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>::BasicScheduleIndividual(std::random_device& randomDevice,
+                                                                          const ScheduleData* pData,
+                                                                          ScheduleChromosomes chromosomes,
+                                                                          const FitnessPolicy& fitnessPolicy)
+    : pData_(pData)
+    , fitnessPolicy_(fitnessPolicy)
+    , evaluatedValue_(NOT_EVALUATED)
+    , chromosomes_(std::move(chromosomes))
+    , randomGenerator_(randomDevice())
 {
+    assert(pData != nullptr);
+    assert(chromosomes_.Lessons().size() == pData->SubjectRequests().size());
+}
+
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>::BasicScheduleIndividual(std::mt19937& randGen,
+                                                                          const ScheduleData* pData,
+                                                                          ScheduleChromosomes chromosomes,
+                                                                          const FitnessPolicy& fitnessPolicy)
+    : pData_(pData)
+    , fitnessPolicy_(fitnessPolicy)
+    , evaluatedValue_(NOT_EVALUATED)
+    , chromosomes_(std::move(chromosomes))
+    , randomGenerator_(randGen())
+{
+    assert(pData != nullptr);
+    assert(chromosomes_.Lessons().size() == pData->SubjectRequests().size());
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleIndividual<Calendar, FitnessPolicy>::swap(BasicScheduleIndividual& other) noexcept
+{
+    std::swap(pData_, other.pData_);
+    std::swap(fitnessPolicy_, other.fitnessPolicy_);
     std::swap(evaluatedValue_, other.evaluatedValue_);
     std::swap(chromosomes_, other.chromosomes_);
+    std::swap(randomGenerator_, other.randomGenerator_);
 }
 
-ScheduleIndividual::ScheduleIndividual(const ScheduleIndividual& other)
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>::BasicScheduleIndividual(const BasicScheduleIndividual& other)
     : pData_(other.pData_)
+    , fitnessPolicy_(other.fitnessPolicy_)
     , evaluatedValue_(other.evaluatedValue_)
     , chromosomes_(other.chromosomes_)
     , randomGenerator_(other.randomGenerator_)
 {
 }
 
-ScheduleIndividual& ScheduleIndividual::operator=(const ScheduleIndividual& other)
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>& BasicScheduleIndividual<Calendar, FitnessPolicy>::operator=(const BasicScheduleIndividual& other)
 {
-    ScheduleIndividual tmp(other);
-    tmp.swap(*this);
+    // own random generator is kept, so that several copies of the same individual do not mutate identically
+    pData_ = other.pData_;
+    fitnessPolicy_ = other.fitnessPolicy_;
+    evaluatedValue_ = other.evaluatedValue_;
+    chromosomes_ = other.chromosomes_;
     return *this;
 }
 
-ScheduleIndividual::ScheduleIndividual(ScheduleIndividual&& other) noexcept
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>::BasicScheduleIndividual(BasicScheduleIndividual&& other) noexcept
     : pData_(other.pData_)
+    , fitnessPolicy_(other.fitnessPolicy_)
     , evaluatedValue_(other.evaluatedValue_)
     , chromosomes_(std::move(other.chromosomes_))
     , randomGenerator_(other.randomGenerator_)
 {
 }
 
-ScheduleIndividual& ScheduleIndividual::operator=(ScheduleIndividual&& other) noexcept
+template<typename Calendar, typename FitnessPolicy>
+BasicScheduleIndividual<Calendar, FitnessPolicy>& BasicScheduleIndividual<Calendar, FitnessPolicy>::operator=(BasicScheduleIndividual&& other) noexcept
 {
     other.swap(*this);
     return *this;
 }
 
-std::size_t ScheduleIndividual::MutationProbability() const
+template<typename Calendar, typename FitnessPolicy>
+std::size_t BasicScheduleIndividual<Calendar, FitnessPolicy>::MutationProbability() const
 {
     std::uniform_int_distribution<std::size_t> mutateDistrib(0, 100);
     return mutateDistrib(randomGenerator_);
 }
 
-void ScheduleIndividual::Mutate()
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleIndividual<Calendar, FitnessPolicy>::Mutate()
+{
+    RandomMove();
+}
+
+template<typename Calendar, typename FitnessPolicy>
+ScheduleMove BasicScheduleIndividual<Calendar, FitnessPolicy>::RandomMove()
 {
     std::uniform_int_distribution<std::size_t> requestsDistrib(0, pData_->SubjectRequests().size() - 1);
     const std::size_t requestIndex = requestsDistrib(randomGenerator_);
+    const ScheduleMove move{
+        .Request = requestIndex,
+        // read through const chromosomes, so that genes shared with other copies are not cloned by failed mutations
+        .OldLesson = Chromosomes().Lesson(requestIndex),
+        .OldClassroom = Chromosomes().Classroom(requestIndex)
+    };
 
     std::uniform_int_distribution<std::size_t> headsOrTails(0, 1);
     if(headsOrTails(randomGenerator_))
         ChangeClassroom(requestIndex);
     else
         ChangeLesson(requestIndex);
+
+    return move;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleIndividual<Calendar, FitnessPolicy>::UndoMove(const ScheduleMove& move)
+{
+    chromosomes_.Lesson(move.Request) = move.OldLesson;
+    chromosomes_.Classroom(move.Request) = move.OldClassroom;
+    evaluatedValue_ = NOT_EVALUATED;
 }
 
-std::size_t ScheduleIndividual::Evaluate() const
+template<typename Calendar, typename FitnessPolicy>
+std::size_t BasicScheduleIndividual<Calendar, FitnessPolicy>::Evaluate() const
 {
     if(evaluatedValue_ != NOT_EVALUATED)
         return evaluatedValue_;
 
-    evaluatedValue_ = ::Evaluate(chromosomes_, *pData_);
+    evaluatedValue_ = ::Evaluate(chromosomes_, *pData_, fitnessPolicy_);
     return evaluatedValue_;
 }
 
-void ScheduleIndividual::Crossover(ScheduleIndividual& other)
+template<typename Calendar, typename FitnessPolicy>
+bool BasicScheduleIndividual<Calendar, FitnessPolicy>::Evaluated() const
+{
+    return evaluatedValue_ != NOT_EVALUATED;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+bool BasicScheduleIndividual<Calendar, FitnessPolicy>::Crossover(BasicScheduleIndividual& other)
 {
     std::uniform_int_distribution<std::size_t> requestsDist(0, pData_->SubjectRequests().size() - 1);
     const auto requestIndex = requestsDist(randomGenerator_);
+    CountScheduleEvent(ScheduleCounter::CrossoverCalls);
     if(ReadyToCrossover(chromosomes_, other.chromosomes_, *pData_, requestIndex))
     {
         evaluatedValue_ = NOT_EVALUATED;
         other.evaluatedValue_ = NOT_EVALUATED;
         ::Crossover(chromosomes_, other.chromosomes_, requestIndex);
+        return true;
     }
+
+    CountScheduleEvent(ScheduleCounter::CrossoverRejections);
+    return false;
 }
 
+template<typename Calendar, typename FitnessPolicy>
+std::size_t BasicScheduleIndividual<Calendar, FitnessPolicy>::Repair()
+{
+    const std::size_t repaired = ::Repair(chromosomes_, *pData_);
+    if(repaired > 0)
+        evaluatedValue_ = NOT_EVALUATED;
 
-void ScheduleIndividual::ChangeClassroom(std::size_t requestIndex)
+    return repaired;
+}
+
+template<typename Calendar, typename FitnessPolicy>
+std::size_t BasicScheduleIndividual<Calendar, FitnessPolicy>::LocalSearch(std::size_t movesBudget)
+{
+    // genes shared with other copies are cloned by the first tried move, they are shared again if no move was kept
+    const std::optional<ScheduleChromosomes> sharedGenes = chromosomes_.SharesGenes() ? std::optional(chromosomes_) : std::nullopt;
+    IncrementalEvaluator<Calendar, FitnessPolicy> evaluator(chromosomes_, *pData_, fitnessPolicy_);
+    std::size_t currentValue = evaluator.Value();
+    std::size_t improvements = 0;
+
+    for(std::size_t m = 0; m < movesBudget; ++m)
+    {
+        const ScheduleMove move = RandomMove();
+        const std::size_t newLesson = Chromosomes().Lesson(move.Request);
+        const ClassroomAddress newClassroom = Chromosomes().Classroom(move.Request);
+        if(newLesson == move.OldLesson && newClassroom == move.OldClassroom)
+            continue;
+
+        evaluator.Update(chromosomes_, move.Request, move.OldLesson, move.OldClassroom);
+        if(const std::size_t newValue = evaluator.Value(); newValue < currentValue)
+        {
+            currentValue = newValue;
+            ++improvements;
+            continue;
+        }
+
+        UndoMove(move);
+        evaluator.Update(chromosomes_, move.Request, newLesson, newClassroom);
+    }
+
+    if(improvements == 0 && sharedGenes)
+        chromosomes_ = *sharedGenes;
+
+    evaluatedValue_ = currentValue;
+    return improvements;
+}
+
+
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleIndividual<Calendar, FitnessPolicy>::ChangeClassroom(std::size_t requestIndex)
 {
     const auto& request = pData_->SubjectRequests().at(requestIndex);
     const auto& classrooms = request.Classrooms();
 
+    CountScheduleEvent(ScheduleCounter::ChangeClassroomCalls);
     if(classrooms.empty())
         return;
 
@@ -109,85 +244,94 @@ void ScheduleIndividual::ChangeClassroom(std::size_t requestIndex)
 
     std::size_t chooseClassroomTry = 0;
     while(chooseClassroomTry < classrooms.size() && 
-          chromosomes_.ClassroomsIntersects(chromosomes_.Lesson(requestIndex), scheduleClassroom))
+          chromosomes_.ClassroomsIntersects(Chromosomes().Lesson(requestIndex), scheduleClassroom))
     {
         scheduleClassroom = classrooms.at(classroomDistrib(randomGenerator_));
         ++chooseClassroomTry;
     }
 
+    CountScheduleEvent(ScheduleCounter::ChangeClassroomTries, chooseClassroomTry + 1);
     if(chooseClassroomTry < classrooms.size())
     {
         chromosomes_.Classroom(requestIndex) = scheduleClassroom;
         evaluatedValue_ = NOT_EVALUATED;
     }
+    else
+    {
+        CountScheduleEvent(ScheduleCounter::ChangeClassroomFailures);
+    }
 }
 
-void ScheduleIndividual::ChangeLesson(std::size_t requestIndex)
+template<typename Calendar, typename FitnessPolicy>
+void BasicScheduleIndividual<Calendar, FitnessPolicy>::ChangeLesson(std::size_t requestIndex)
 {
-    const auto& request = pData_->SubjectRequests().at(requestIndex);
-    if(pData_->SubjectRequestHasLockedLesson(request))
-        return;
-
-    std::uniform_int_distribution<std::size_t> lessonsDistrib(0, MAX_LESSONS_COUNT - 1);
-    std::size_t scheduleLesson = lessonsDistrib(randomGenerator_);
-
-    std::size_t chooseLessonTry = 0;
-    while(chooseLessonTry < MAX_LESSONS_COUNT && 
-        (!request.RequestedWeekDay(scheduleLesson / MAX_LESSONS_PER_DAY) || 
-            IsLateScheduleLessonInSaturday(scheduleLesson) ||
-            chromosomes_.GroupsOrProfessorsOrClassroomsIntersects(*pData_, requestIndex, scheduleLesson)))
+    CountScheduleEvent(ScheduleCounter::ChangeLessonCalls);
+    if(pData_->RequestHasLockedLesson(requestIndex))
     {
-        scheduleLesson = lessonsDistrib(randomGenerator_);
-        ++chooseLessonTry;
+        CountScheduleEvent(ScheduleCounter::ChangeLessonFailures);
+        return;
     }
 
-    if(chooseLessonTry < MAX_LESSONS_COUNT)
+    const LessonsMask freeLessons = chromosomes_.FreeLessons(*pData_, requestIndex);
+    if(freeLessons.None())
     {
-        chromosomes_.Lesson(requestIndex) = scheduleLesson;
-        evaluatedValue_ = NOT_EVALUATED;
+        CountScheduleEvent(ScheduleCounter::ChangeLessonFailures);
+        return;
     }
-}
 
+    std::uniform_int_distribution<std::size_t> lessonsDistrib(0, freeLessons.Count() - 1);
+    chromosomes_.Lesson(requestIndex) = freeLessons.NthLesson(lessonsDistrib(randomGenerator_));
+    evaluatedValue_ = NOT_EVALUATED;
+}
 
-void swap(ScheduleIndividual& lhs, ScheduleIndividual& rhs) { lhs.swap(rhs); }
 
-void Print(const ScheduleIndividual& individ,
-           const ScheduleData& data)
+template<typename Calendar, typename FitnessPolicy>
+void Print(const BasicScheduleIndividual<Calendar, FitnessPolicy>& individ,
+           const BasicScheduleData<Calendar>& data)
 {
     const auto& requests = data.SubjectRequests();
-    const auto& lessons = individ.Chromosomes().Lessons();
-    const auto& classrooms = individ.Chromosomes().Classrooms();
+    const auto& chromosomes = individ.Chromosomes();
+    const BasicScheduleSlots<Calendar> slots(chromosomes);
 
-    for(std::size_t l = 0; l < MAX_LESSONS_COUNT; ++l)
+    std::string out;
+    for(std::size_t l = 0; l < Calendar::MaxLessonsCount; ++l)
     {
-        std::cout << "Lesson " << l << ": ";
+        out += "Lesson " + std::to_string(l) + ": ";
 
-        auto it = std::find(lessons.begin(), lessons.end(), l);
-        if(it == lessons.end())
-        {
-            std::cout << '-';
-        }
-        else
-        {
-            while(it != lessons.end())
-            { 
-                const std::size_t r = std::distance(lessons.begin(), it);
-                const auto& request = requests.at(r);
-                std::cout << "[s:" << request.ID() <<
-                    ", p:" << request.Professor() <<
-                    ", c:(" << classrooms.at(r).Building << ", " << classrooms.at(r).Classroom << "), g: {";
+        const auto lessonRequests = slots.Requests(l);
+        if(lessonRequests.empty())
+            out += '-';
 
-                for(auto&& g : request.Groups())
-                    std::cout << ' ' << g;
+        for(std::size_t r : lessonRequests)
+        {
+            const auto& request = requests.at(r);
+            const ClassroomAddress classroom = chromosomes.Classroom(r);
+            out += "[s:" + std::to_string(request.ID()) +
+                ", p:" + std::to_string(request.Professor()) +
+                ", c:(" + std::to_string(classroom.Building) + ", " + std::to_string(classroom.Classroom) + "), g: {";
 
-                std::cout << " }]";
+            for(auto&& g : request.Groups())
+                out += ' ' + std::to_string(g);
 
-                it = std::find(std::next(it), lessons.end(), l);
-            }
+            out += " }]";
         }
 
-        std::cout << '\n';
+        out += '\n';
     }
 
+    std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
     std::cout.flush();
 }
+
+
+#define INSTANTIATE_SCHEDULE_INDIVIDUAL(Calendar, FitnessPolicy) \
+    template class BasicScheduleIndividual<Calendar, FitnessPolicy>; \
+    template void Print(const BasicScheduleIndividual<Calendar, FitnessPolicy>&, const BasicScheduleData<Calendar>&);
+
+INSTANTIATE_SCHEDULE_INDIVIDUAL(DefaultScheduleCalendar, DefaultFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(EightLessonsScheduleCalendar, DefaultFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(OneWeekScheduleCalendar, DefaultFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(DefaultScheduleCalendar, RuntimeFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(EightLessonsScheduleCalendar, RuntimeFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(OneWeekScheduleCalendar, RuntimeFitnessPolicy)
+INSTANTIATE_SCHEDULE_INDIVIDUAL(DefaultScheduleCalendar, NoBuildingsFitnessPolicy)
@@ -8,26 +8,68 @@
 #include <tuple>
 
 
-class ScheduleIndividual
+// single request move, keeps previous genes to be able to undo it
+struct ScheduleMove
 {
-public:
-    explicit ScheduleIndividual(std::random_device& randomDevice,
-                                const ScheduleData* pData);
-    void swap(ScheduleIndividual& other) noexcept;
+    std::size_t Request = 0;
+    std::size_t OldLesson = 0;
+    ClassroomAddress OldClassroom;
+};
 
-    ScheduleIndividual(const ScheduleIndividual& other);
-    ScheduleIndividual& operator=(const ScheduleIndividual& other);
 
-    ScheduleIndividual(ScheduleIndividual&& other) noexcept;
-    ScheduleIndividual& operator=(ScheduleIndividual&& other) noexcept;
+template<typename Calendar, typename FitnessPolicy = DefaultFitnessPolicy>
+class BasicScheduleIndividual
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+    using ScheduleChromosomes = BasicScheduleChromosomes<Calendar>;
+
+    explicit BasicScheduleIndividual(std::random_device& randomDevice,
+                                     const ScheduleData* pData,
+                                     const FitnessPolicy& fitnessPolicy = {});
+    explicit BasicScheduleIndividual(std::random_device& randomDevice,
+                                     const ScheduleData* pData,
+                                     ScheduleChromosomes chromosomes,
+                                     const FitnessPolicy& fitnessPolicy = {});
+    // seeds own random generator from randGen, used when individuals are built concurrently
+    explicit BasicScheduleIndividual(std::mt19937& randGen,
+                                     const ScheduleData* pData,
+                                     ScheduleChromosomes chromosomes,
+                                     const FitnessPolicy& fitnessPolicy = {});
+    void swap(BasicScheduleIndividual& other) noexcept;
+
+    // copy assignment keeps own random generator, swap and move assignment exchange it with everything else
+    BasicScheduleIndividual(const BasicScheduleIndividual& other);
+    BasicScheduleIndividual& operator=(const BasicScheduleIndividual& other);
+
+    BasicScheduleIndividual(BasicScheduleIndividual&& other) noexcept;
+    BasicScheduleIndividual& operator=(BasicScheduleIndividual&& other) noexcept;
 
     const ScheduleData& Data() const { return *pData_; }
     const ScheduleChromosomes& Chromosomes() const { return chromosomes_; }
+    const FitnessPolicy& Policy() const { return fitnessPolicy_; }
 
     std::size_t MutationProbability() const;
     void Mutate();
+    ScheduleMove RandomMove();
+    void UndoMove(const ScheduleMove& move);
     std::size_t Evaluate() const;
-    void Crossover(ScheduleIndividual& other);
+    bool Evaluated() const;
+    // returns false if crossover was rejected because it would break hard constraints
+    bool Crossover(BasicScheduleIndividual& other);
+
+    // places requests left without a lesson or a classroom, returns number of repaired requests
+    std::size_t Repair();
+
+    // hill climbing: tries movesBudget random moves of single requests to other lessons or classrooms,
+    // keeps only improving ones, returns number of improvements
+    std::size_t LocalSearch(std::size_t movesBudget);
+
+    // bytes of the individual together with its chromosomes, random generator state is stored inline
+    std::size_t MemoryUsage() const { return sizeof(*this) + chromosomes_.MemoryUsage(); }
+
+    // restarts random generator, used to decorrelate copies of the same individual
+    void Reseed(std::mt19937::result_type seed) { randomGenerator_.seed(seed); }
 
 private:
     void ChangeClassroom(std::size_t requestIndex);
@@ -35,17 +77,22 @@ private:
 
 private:
     const ScheduleData* pData_;
+    [[no_unique_address]] FitnessPolicy fitnessPolicy_;
     mutable std::size_t evaluatedValue_;
     ScheduleChromosomes chromosomes_;
     mutable std::mt19937 randomGenerator_;
 };
 
-void swap(ScheduleIndividual& lhs, ScheduleIndividual& rhs);
+using ScheduleIndividual = BasicScheduleIndividual<DefaultScheduleCalendar>;
+
+template<typename Calendar, typename FitnessPolicy>
+void swap(BasicScheduleIndividual<Calendar, FitnessPolicy>& lhs, BasicScheduleIndividual<Calendar, FitnessPolicy>& rhs) { lhs.swap(rhs); }
 
 
 struct ScheduleIndividualLess
 {
-    bool operator()(const ScheduleIndividual& lhs, const ScheduleIndividual& rhs) const
+    template<typename Individual>
+    bool operator()(const Individual& lhs, const Individual& rhs) const
     {
         return lhs.Evaluate() < rhs.Evaluate();
     }
@@ -53,30 +100,46 @@ struct ScheduleIndividualLess
 
 struct ScheduleIndividualEvaluator
 {
-    void operator()(ScheduleIndividual& individual) const
+    // returns number of performed evaluations
+    template<typename Individual>
+    std::size_t operator()(Individual& individual) const
     {
+        const bool evaluated = individual.Evaluated();
         individual.Evaluate();
+        return !evaluated;
     }
 };
 
 struct ScheduleIndividualMutator
 {
-    explicit ScheduleIndividualMutator(std::size_t mutationChance)
+    explicit ScheduleIndividualMutator(std::size_t mutationChance, bool repair = false)
         : MutationChance(mutationChance)
+        , RepairMutated(repair)
     { }
 
-    void operator()(ScheduleIndividual& individual) const
+    // returns number of performed evaluations
+    template<typename Individual>
+    std::size_t operator()(Individual& individual) const
     {
         if(individual.MutationProbability() <= MutationChance)
         {
             individual.Mutate();
+            if(RepairMutated)
+                individual.Repair();
+
+            const bool evaluated = individual.Evaluated();
             individual.Evaluate();
+            return !evaluated;
         }
+
+        return 0;
     }
 
     std::size_t MutationChance;
+    bool RepairMutated;
 };
 
 
-void Print(const ScheduleIndividual& individ,
-           const ScheduleData& data);
+template<typename Calendar, typename FitnessPolicy>
+void Print(const BasicScheduleIndividual<Calendar, FitnessPolicy>& individ,
+           const BasicScheduleData<Calendar>& data);
@@ -0,0 +1,316 @@
+#include "ScheduleIslands.h"
+
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+
+static constexpr std::uint8_t SERIALIZED_NO_LESSON = std::numeric_limits<std::uint8_t>::max();
+static constexpr std::uint32_t SERIALIZED_NO_ADDRESS = std::numeric_limits<std::uint32_t>::max();
+static constexpr std::size_t SERIALIZED_GENE_SIZE = sizeof(std::uint8_t) + 2 * sizeof(std::uint32_t);
+
+
+// Gene is packed as [lesson: u8, building: u32, classroom: u32]
+template<typename Calendar>
+static void SerializeChromosomes(const BasicScheduleChromosomes<Calendar>& chromosomes, std::uint8_t* out)
+{
+    static_assert(Calendar::MaxLessonsCount < SERIALIZED_NO_LESSON, "lessons must fit into one byte");
+
+    auto toAddress = [](std::size_t value)
+    {
+        return value == std::numeric_limits<std::size_t>::max() ? SERIALIZED_NO_ADDRESS : static_cast<std::uint32_t>(value);
+    };
+
+    for(std::size_t r = 0; r < chromosomes.Lessons().size(); ++r)
+    {
+        const std::size_t lesson = chromosomes.Lesson(r);
+        const std::uint8_t packedLesson = lesson < Calendar::MaxLessonsCount ? static_cast<std::uint8_t>(lesson) : SERIALIZED_NO_LESSON;
+        const std::uint32_t building = toAddress(chromosomes.Classroom(r).Building);
+        const std::uint32_t classroom = toAddress(chromosomes.Classroom(r).Classroom);
+
+        std::memcpy(out, &packedLesson, sizeof(packedLesson));
+        std::memcpy(out + sizeof(packedLesson), &building, sizeof(building));
+        std::memcpy(out + sizeof(packedLesson) + sizeof(building), &classroom, sizeof(classroom));
+        out += SERIALIZED_GENE_SIZE;
+    }
+}
+
+template<typename Calendar>
+static BasicScheduleChromosomes<Calendar> DeserializeChromosomes(const std::uint8_t* in, std::size_t requestsCount)
+{
+    auto fromAddress = [](std::uint32_t value)
+    {
+        return value == SERIALIZED_NO_ADDRESS ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(value);
+    };
+
+    std::vector<std::size_t> lessons(requestsCount);
+    std::vector<ClassroomAddress> classrooms(requestsCount);
+    for(std::size_t r = 0; r < requestsCount; ++r)
+    {
+        std::uint8_t packedLesson = 0;
+        std::uint32_t building = 0;
+        std::uint32_t classroom = 0;
+        std::memcpy(&packedLesson, in, sizeof(packedLesson));
+        std::memcpy(&building, in + sizeof(packedLesson), sizeof(building));
+        std::memcpy(&classroom, in + sizeof(packedLesson) + sizeof(building), sizeof(classroom));
+        in += SERIALIZED_GENE_SIZE;
+
+        lessons[r] = packedLesson == SERIALIZED_NO_LESSON ? std::numeric_limits<std::size_t>::max() : packedLesson;
+        classrooms[r] = ClassroomAddress(fromAddress(building), fromAddress(classroom));
+    }
+
+    return BasicScheduleChromosomes<Calendar>(std::move(lessons), std::move(classrooms));
+}
+
+
+// Header of a single-producer single-consumer ring placed in shared memory,
+// slots follow the header. Every slot is [fitness: u64, serialized chromosomes].
+struct MigrantsRingHeader
+{
+    std::atomic<std::uint64_t> Head;
+    std::atomic<std::uint64_t> Tail;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared memory rings require address-free atomics");
+
+
+class IslandsSharedMemory
+{
+public:
+    explicit IslandsSharedMemory(std::size_t islandsCount,
+                                 std::size_t ringCapacity,
+                                 std::size_t requestsCount)
+        : islandsCount_(islandsCount)
+        , ringCapacity_(ringCapacity)
+        , slotSize_(AlignUp(sizeof(std::uint64_t) + requestsCount * SERIALIZED_GENE_SIZE))
+        , islandSize_(AlignUp(sizeof(MigrantsRingHeader)) + (ringCapacity + 1) * slotSize_)
+        , size_(islandsCount * islandSize_)
+        , pMemory_(nullptr)
+    {
+        static std::atomic<unsigned> counter = 0;
+        const std::string name = "/ScheduleGA-islands-" + std::to_string(::getpid()) + '-' + std::to_string(counter++);
+
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd < 0)
+            throw std::runtime_error("Unable to create shared memory segment " + name);
+
+        // name is not needed after mapping: children inherit the mapping, segment is freed with the last unmap
+        ::shm_unlink(name.c_str());
+        if(::ftruncate(fd, static_cast<off_t>(size_)) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Unable to resize shared memory segment " + name);
+        }
+
+        void* pMemory = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(pMemory == MAP_FAILED)
+            throw std::runtime_error("Unable to map shared memory segment " + name);
+
+        pMemory_ = static_cast<std::uint8_t*>(pMemory);
+        for(std::size_t i = 0; i < islandsCount_; ++i)
+            new(Island(i)) MigrantsRingHeader{0, 0};
+    }
+
+    ~IslandsSharedMemory() { ::munmap(pMemory_, size_); }
+
+    IslandsSharedMemory(const IslandsSharedMemory&) = delete;
+    IslandsSharedMemory& operator=(const IslandsSharedMemory&) = delete;
+
+    std::size_t IslandsCount() const { return islandsCount_; }
+    std::size_t RingCapacity() const { return ringCapacity_; }
+
+    MigrantsRingHeader& Ring(std::size_t island) { return *reinterpret_cast<MigrantsRingHeader*>(Island(island)); }
+    std::uint8_t* Slot(std::size_t island, std::size_t slot) { return Island(island) + AlignUp(sizeof(MigrantsRingHeader)) + slot * slotSize_; }
+    // slot after the ring keeps island's final best individual
+    std::uint8_t* ResultSlot(std::size_t island) { return Slot(island, ringCapacity_); }
+
+private:
+    static std::size_t AlignUp(std::size_t size) { return (size + 63) / 64 * 64; }
+    std::uint8_t* Island(std::size_t island) { return pMemory_ + island * islandSize_; }
+
+private:
+    std::size_t islandsCount_;
+    std::size_t ringCapacity_;
+    std::size_t slotSize_;
+    std::size_t islandSize_;
+    std::size_t size_;
+    std::uint8_t* pMemory_;
+};
+
+
+template<typename Calendar>
+class SharedMemoryMigration : public BasicScheduleGAMigration<Calendar>
+{
+public:
+    explicit SharedMemoryMigration(IslandsSharedMemory& memory,
+                                   std::size_t island,
+                                   std::size_t requestsCount)
+        : memory_(memory)
+        , island_(island)
+        , requestsCount_(requestsCount)
+    {
+    }
+
+    void Emigrate(const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t fitness) override
+    {
+        const std::size_t target = (island_ + 1) % memory_.IslandsCount();
+        auto& ring = memory_.Ring(target);
+
+        const std::uint64_t tail = ring.Tail.load(std::memory_order_relaxed);
+        if(tail - ring.Head.load(std::memory_order_acquire) >= memory_.RingCapacity())
+            return; // receiver is behind, migrant is dropped
+
+        WriteSlot(memory_.Slot(target, tail % memory_.RingCapacity()), chromosomes, fitness);
+        ring.Tail.store(tail + 1, std::memory_order_release);
+    }
+
+    std::vector<BasicScheduleChromosomes<Calendar>> Immigrate() override
+    {
+        auto& ring = memory_.Ring(island_);
+        std::uint64_t head = ring.Head.load(std::memory_order_relaxed);
+        const std::uint64_t tail = ring.Tail.load(std::memory_order_acquire);
+
+        std::vector<BasicScheduleChromosomes<Calendar>> immigrants;
+        for(; head != tail; ++head)
+        {
+            const std::uint8_t* pSlot = memory_.Slot(island_, head % memory_.RingCapacity());
+            immigrants.emplace_back(DeserializeChromosomes<Calendar>(pSlot + sizeof(std::uint64_t), requestsCount_));
+        }
+
+        ring.Head.store(head, std::memory_order_release);
+        return immigrants;
+    }
+
+    void PublishResult(const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t fitness)
+    {
+        WriteSlot(memory_.ResultSlot(island_), chromosomes, fitness);
+    }
+
+    static void WriteSlot(std::uint8_t* pSlot, const BasicScheduleChromosomes<Calendar>& chromosomes, std::size_t fitness)
+    {
+        const std::uint64_t packedFitness = fitness;
+        std::memcpy(pSlot, &packedFitness, sizeof(packedFitness));
+        SerializeChromosomes(chromosomes, pSlot + sizeof(packedFitness));
+    }
+
+private:
+    IslandsSharedMemory& memory_;
+    std::size_t island_;
+    std::size_t requestsCount_;
+};
+
+
+template<typename Calendar>
+BasicScheduleIslandsResult<Calendar> RunScheduleIslands(const BasicScheduleData<Calendar>& scheduleData,
+                                                        const ScheduleIslandsParams& params)
+{
+    if(params.IslandsCount <= 0)
+        throw std::invalid_argument("Invalid IslandsCount option: must be greater than zero");
+
+    if(params.MigrantsCapacity <= 0)
+        throw std::invalid_argument("Invalid MigrantsCapacity option: must be greater than zero");
+
+    if(params.GAParams.MigrationInterval <= 0)
+        throw std::invalid_argument("Invalid MigrationInterval option: islands must migrate");
+
+    // validate GA params before forking, nothing below runs parallel algorithms until all islands are forked
+    const BasicScheduleGA<Calendar> validatedParams(params.GAParams);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    const std::size_t requestsCount = scheduleData.SubjectRequests().size();
+    IslandsSharedMemory memory(params.IslandsCount, params.MigrantsCapacity, requestsCount);
+
+    std::vector<pid_t> islands;
+    for(std::size_t island = 0; island < static_cast<std::size_t>(params.IslandsCount); ++island)
+    {
+        const pid_t pid = ::fork();
+        if(pid < 0)
+        {
+            for(pid_t started : islands)
+                ::waitpid(started, nullptr, 0);
+
+            throw std::runtime_error("Unable to start island process");
+        }
+
+        if(pid == 0)
+        {
+            int exitCode = 0;
+            try
+            {
+                SharedMemoryMigration<Calendar> migration(memory, island, requestsCount);
+                // islands of a seeded run get different but repeatable seeds
+                ScheduleGAParams islandParams = params.GAParams;
+                if(islandParams.Seed != 0)
+                    islandParams.Seed += island;
+
+                // TBB pool of the caller may already be started and its threads do not exist in the child,
+                // so islands never run parallel algorithms; steady-state workers are own threads of the island
+                islandParams.SingleThreaded = islandParams.SingleThreaded || islandParams.Mode != ScheduleGAMode::SteadyState;
+
+                BasicScheduleGA<Calendar> algo(islandParams);
+                algo.SetMigration(&migration);
+                algo.Start(scheduleData);
+
+                const auto& best = algo.Individuals().front();
+                migration.PublishResult(best.Chromosomes(), best.Evaluate());
+            }
+            catch(...)
+            {
+                exitCode = 1;
+            }
+
+            ::_exit(exitCode);
+        }
+
+        islands.emplace_back(pid);
+    }
+
+    // a failed island only loses its own population, survivors' results are kept
+    std::vector<std::size_t> islandsFitness;
+    std::vector<std::size_t> failedIslands;
+    for(std::size_t island = 0; island < islands.size(); ++island)
+    {
+        int status = 0;
+        if(::waitpid(islands[island], &status, 0) != islands[island] || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            failedIslands.emplace_back(island);
+            islandsFitness.emplace_back(std::numeric_limits<std::size_t>::max());
+            continue;
+        }
+
+        std::uint64_t fitness = 0;
+        std::memcpy(&fitness, memory.ResultSlot(island), sizeof(fitness));
+        islandsFitness.emplace_back(fitness);
+    }
+
+    if(failedIslands.size() == islands.size())
+        throw std::runtime_error("All island processes failed");
+
+    const std::size_t bestIsland = std::distance(islandsFitness.begin(), std::ranges::min_element(islandsFitness));
+    BasicScheduleIslandsResult<Calendar> result{
+        .Best = DeserializeChromosomes<Calendar>(memory.ResultSlot(bestIsland) + sizeof(std::uint64_t), requestsCount),
+        .BestFitness = islandsFitness.at(bestIsland),
+        .IslandsFitness = std::move(islandsFitness),
+        .FailedIslands = std::move(failedIslands)
+    };
+
+    result.Time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginTime);
+    return result;
+}
+
+
+#define INSTANTIATE_SCHEDULE_ISLANDS(Calendar) \
+    template BasicScheduleIslandsResult<Calendar> RunScheduleIslands(const BasicScheduleData<Calendar>&, const ScheduleIslandsParams&);
+
+INSTANTIATE_SCHEDULE_ISLANDS(DefaultScheduleCalendar)
+INSTANTIATE_SCHEDULE_ISLANDS(EightLessonsScheduleCalendar)
+INSTANTIATE_SCHEDULE_ISLANDS(OneWeekScheduleCalendar)
@@ -0,0 +1,45 @@
+#pragma once
+#include "ScheduleCommon.h"
+#include "ScheduleChromosomes.h"
+#include "ScheduleGA.h"
+
+#include <vector>
+#include <chrono>
+#include <limits>
+
+
+struct ScheduleIslandsParams
+{
+    int IslandsCount = 0;
+    // capacity of each island's incoming migrants ring buffer
+    int MigrantsCapacity = 4;
+    // population parameters of every island, MigrationInterval must be greater than zero
+    ScheduleGAParams GAParams;
+};
+
+
+template<typename Calendar>
+struct BasicScheduleIslandsResult
+{
+    BasicScheduleChromosomes<Calendar> Best;
+    std::size_t BestFitness = 0;
+    // fitness of every island's best individual, failed islands have std::numeric_limits<std::size_t>::max()
+    std::vector<std::size_t> IslandsFitness;
+    // indexes of islands whose processes did not finish successfully
+    std::vector<std::size_t> FailedIslands;
+    std::chrono::milliseconds Time{0};
+};
+
+using ScheduleIslandsResult = BasicScheduleIslandsResult<DefaultScheduleCalendar>;
+
+
+// Runs IslandsCount solver processes (POSIX only), each with its own ScheduleGA population.
+// Islands form a ring: every island sends its best individual to the next one
+// through a lock-free ring buffer in shared memory. Calling process waits for islands and collects the global best
+// of the islands which finished successfully, it throws only if every island has failed.
+// Islands are forked from the calling process, which may already run the thread pool of parallel algorithms;
+// the pool is not usable after fork, so generational islands run single-threaded and parallelism comes from
+// IslandsCount, steady-state islands start their own ThreadsCount workers.
+template<typename Calendar>
+BasicScheduleIslandsResult<Calendar> RunScheduleIslands(const BasicScheduleData<Calendar>& scheduleData,
+                                                        const ScheduleIslandsParams& params);
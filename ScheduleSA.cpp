@@ -0,0 +1,159 @@
+#include "ScheduleSA.h"
+
+#include <cmath>
+#include <deque>
+#include <random>
+#include <cassert>
+#include <execution>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+
+template<typename Calendar>
+BasicScheduleSA<Calendar>::BasicScheduleSA() : BasicScheduleSA(BasicScheduleSA::DefaultParams())
+{
+}
+
+template<typename Calendar>
+BasicScheduleSA<Calendar>::BasicScheduleSA(const ScheduleSAParams& params)
+    : params_(params)
+    , individuals_()
+{
+    if(params_.ChainsCount <= 0)
+        throw std::invalid_argument("Invalid ChainsCount option: must be greater than zero");
+
+    if(params_.IterationsCount < 0)
+        throw std::invalid_argument("Invalid IterationsCount option: must be greater or equal to zero");
+
+    if(params_.FinalTemperature <= 0.0 || params_.InitialTemperature < params_.FinalTemperature)
+        throw std::invalid_argument("Invalid temperature options: must be 0 < FinalTemperature <= InitialTemperature");
+
+    if(params_.TabuTenure < 0)
+        throw std::invalid_argument("Invalid TabuTenure option: must be greater or equal to zero");
+}
+
+template<typename Calendar>
+ScheduleSAParams BasicScheduleSA<Calendar>::DefaultParams()
+{
+    return ScheduleSAParams{
+        .ChainsCount = 8,
+        .IterationsCount = 20000,
+        .InitialTemperature = 50.0,
+        .FinalTemperature = 0.5,
+        .TabuTenure = 16
+    };
+}
+
+template<typename Calendar>
+ScheduleGAStatistics BasicScheduleSA<Calendar>::Start(const ScheduleData& scheduleData)
+{
+    std::mt19937 seedGen(params_.Seed != 0 ? params_.Seed : std::random_device{}());
+    individuals_.clear();
+    for(int c = 0; c < params_.ChainsCount; ++c)
+        individuals_.emplace_back(seedGen, &scheduleData, BasicScheduleChromosomes<Calendar>(scheduleData));
+
+    // chains run in parallel, so their seeds are drawn up front
+    std::vector<std::mt19937::result_type> seeds(individuals_.size());
+    std::ranges::generate(seeds, std::ref(seedGen));
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    const auto beginCounters = CollectScheduleCounters();
+
+    ScheduleGAStatistics result{};
+    result.EvaluationsCount = std::transform_reduce(std::execution::par, individuals_.begin(), individuals_.end(),
+                                                    std::size_t{0}, std::plus<>{},
+                                                    [&](ScheduleIndividual& individual)
+    {
+        return RunChain(individual, seeds[&individual - individuals_.data()]);
+    });
+
+    std::ranges::sort(individuals_, ScheduleIndividualLess());
+    result.Time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginTime);
+    std::ranges::transform(CollectScheduleCounters(), beginCounters, result.Counters.begin(), std::minus<>{});
+    if(result.Time.count() > 0)
+        result.EvaluationsPerSecond = static_cast<double>(result.EvaluationsCount) * 1000.0 / static_cast<double>(result.Time.count());
+
+    return result;
+}
+
+template<typename Calendar>
+std::size_t BasicScheduleSA<Calendar>::RunChain(ScheduleIndividual& individual, std::mt19937::result_type seed) const
+{
+    std::mt19937 randGen(seed);
+    ScheduleIndividual current = individual;
+    current.Reseed(randGen());
+
+    IncrementalEvaluator<Calendar> evaluator(current.Chromosomes(), current.Data());
+    std::size_t currentValue = evaluator.Value();
+    std::size_t bestValue = currentValue;
+
+    std::uniform_real_distribution<double> acceptDist(0.0, 1.0);
+
+    // (request, lesson) pairs recently left by the chain
+    std::deque<std::pair<std::size_t, std::size_t>> tabu;
+    auto isTabu = [&](std::size_t request, std::size_t lesson)
+    {
+        return std::ranges::find(tabu, std::pair(request, lesson)) != tabu.end();
+    };
+
+    const double cooling = params_.IterationsCount > 1
+        ? std::pow(params_.FinalTemperature / params_.InitialTemperature, 1.0 / (params_.IterationsCount - 1))
+        : 1.0;
+
+    std::size_t evaluations = 0;
+    double temperature = params_.InitialTemperature;
+    for(int iteration = 0; iteration < params_.IterationsCount; ++iteration, temperature *= cooling)
+    {
+        const ScheduleMove move = current.RandomMove();
+        const std::size_t newLesson = current.Chromosomes().Lesson(move.Request);
+        const ClassroomAddress newClassroom = current.Chromosomes().Classroom(move.Request);
+        if(newLesson == move.OldLesson && newClassroom == move.OldClassroom)
+            continue;
+
+        evaluator.Update(current.Chromosomes(), move.Request, move.OldLesson, move.OldClassroom);
+        const std::size_t newValue = evaluator.Value();
+        ++evaluations;
+
+        // tabu moves are allowed only when they improve the best found value
+        const bool allowed = newValue < bestValue || !isTabu(move.Request, newLesson);
+        const bool accepted = allowed && (newValue <= currentValue ||
+            acceptDist(randGen) < std::exp((static_cast<double>(currentValue) - static_cast<double>(newValue)) / temperature));
+
+        if(!accepted)
+        {
+            current.UndoMove(move);
+            evaluator.Update(current.Chromosomes(), move.Request, newLesson, newClassroom);
+            continue;
+        }
+
+        currentValue = newValue;
+        if(params_.TabuTenure > 0 && newLesson != move.OldLesson)
+        {
+            tabu.emplace_back(move.Request, move.OldLesson);
+            if(tabu.size() > static_cast<std::size_t>(params_.TabuTenure))
+                tabu.pop_front();
+        }
+
+        if(currentValue < bestValue)
+        {
+            bestValue = currentValue;
+            individual = current;
+        }
+    }
+
+    assert(individual.Evaluate() == bestValue);
+    return evaluations;
+}
+
+template<typename Calendar>
+const std::vector<typename BasicScheduleSA<Calendar>::ScheduleIndividual>& BasicScheduleSA<Calendar>::Individuals() const
+{
+    assert(std::ranges::is_sorted(individuals_, ScheduleIndividualLess()));
+    return individuals_;
+}
+
+
+template class BasicScheduleSA<DefaultScheduleCalendar>;
+template class BasicScheduleSA<EightLessonsScheduleCalendar>;
+template class BasicScheduleSA<OneWeekScheduleCalendar>;
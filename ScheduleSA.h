@@ -0,0 +1,49 @@
+#pragma once
+#include "ScheduleCommon.h"
+#include "ScheduleIndividual.h"
+#include "ScheduleGA.h"
+
+#include <vector>
+#include <random>
+
+
+struct ScheduleSAParams
+{
+    int ChainsCount = 0;
+    int IterationsCount = 0;
+    double InitialTemperature = 0.0;
+    double FinalTemperature = 0.0;
+    // number of recent moves which may not be reverted, zero disables tabu list
+    int TabuTenure = 0;
+    // seeds initial individuals and chains, zero draws the seed from std::random_device
+    std::mt19937::result_type Seed = 0;
+};
+
+
+// Simulated annealing over the same chromosomes, moves and objective as ScheduleGA.
+// Independent chains run in parallel, every chain keeps its best individual.
+template<typename Calendar>
+class BasicScheduleSA
+{
+public:
+    using ScheduleData = BasicScheduleData<Calendar>;
+    using ScheduleIndividual = BasicScheduleIndividual<Calendar>;
+
+    BasicScheduleSA();
+    explicit BasicScheduleSA(const ScheduleSAParams& params);
+
+    static ScheduleSAParams DefaultParams();
+    const ScheduleSAParams& Params() const { return params_; }
+
+    ScheduleGAStatistics Start(const ScheduleData& scheduleData);
+    const std::vector<ScheduleIndividual>& Individuals() const;
+
+private:
+    std::size_t RunChain(ScheduleIndividual& individual, std::mt19937::result_type seed) const;
+
+private:
+    ScheduleSAParams params_;
+    std::vector<ScheduleIndividual> individuals_;
+};
+
+using ScheduleSA = BasicScheduleSA<DefaultScheduleCalendar>;
@@ -0,0 +1,98 @@
+#include "ScheduleTrace.h"
+
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+
+static std::atomic<std::uint64_t> TracersCounter = 0;
+
+// tracers alternating on one thread beyond this number register additional buffers of the thread
+static constexpr std::size_t CACHED_TRACERS_PER_THREAD = 8;
+
+
+ScheduleTracer::ScheduleTracer()
+    : id_(++TracersCounter)
+    , beginTime_(std::chrono::steady_clock::now())
+    , buffersMutex_()
+    , buffers_()
+{
+}
+
+void ScheduleTracer::Record(const char* name, char phase)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - beginTime_;
+    CurrentThreadBuffer().Events.push_back(ScheduleTraceEvent{
+        .Name = name,
+        .Phase = phase,
+        .TimestampMicroseconds = std::chrono::duration<double, std::micro>(elapsed).count()
+    });
+}
+
+ScheduleTracer::ThreadBuffer& ScheduleTracer::CurrentThreadBuffer()
+{
+    // pool threads may alternately serve several tracers, so buffers are cached per tracer, most recently used first;
+    // ids are never reused, so a cached buffer of a destroyed tracer is never picked up by a new one and is evicted eventually
+    thread_local std::vector<std::pair<std::uint64_t, ThreadBuffer*>> cachedBuffers;
+    const auto it = std::ranges::find(cachedBuffers, id_, &std::pair<std::uint64_t, ThreadBuffer*>::first);
+    if(it != cachedBuffers.end())
+    {
+        std::rotate(cachedBuffers.begin(), it, it + 1);
+        return *cachedBuffers.front().second;
+    }
+
+    std::lock_guard lock(buffersMutex_);
+    auto& buffer = buffers_.emplace_back(std::make_unique<ThreadBuffer>());
+    buffer->ThreadIndex = buffers_.size();
+
+    cachedBuffers.emplace(cachedBuffers.begin(), id_, buffer.get());
+    if(cachedBuffers.size() > CACHED_TRACERS_PER_THREAD)
+        cachedBuffers.pop_back();
+
+    return *buffer;
+}
+
+std::size_t ScheduleTracer::EventsCount() const
+{
+    std::lock_guard lock(buffersMutex_);
+    std::size_t result = 0;
+    for(const auto& buffer : buffers_)
+        result += buffer->Events.size();
+
+    return result;
+}
+
+void ScheduleTracer::WriteChromeTrace(std::ostream& os) const
+{
+    std::lock_guard lock(buffersMutex_);
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for(const auto& buffer : buffers_)
+    {
+        for(const auto& event : buffer->Events)
+        {
+            if(!first)
+                os << ',';
+
+            first = false;
+            os << "\n{\"name\":\"" << event.Name << "\",\"ph\":\"" << event.Phase
+               << "\",\"ts\":" << event.TimestampMicroseconds << ",\"pid\":1,\"tid\":" << buffer->ThreadIndex << '}';
+        }
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void ScheduleTracer::SaveChromeTrace(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+    if(!file)
+        throw std::runtime_error("Unable to open trace file " + fileName);
+
+    file.precision(3);
+    file << std::fixed;
+    WriteChromeTrace(file);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+
+struct ScheduleTraceEvent
+{
+    // must point to a string literal or other static storage
+    const char* Name = nullptr;
+    // 'B' for begin, 'E' for end, as in Chrome trace format
+    char Phase = 'B';
+    double TimestampMicroseconds = 0.0;
+};
+
+
+// Records begin and end events of solver phases into per-thread buffers
+// and writes them as Chrome trace JSON (viewable in chrome://tracing or Perfetto).
+// Every thread appends only to its own buffer without locks, buffers are registered once per thread and tracer,
+// so one thread may record into several tracers alternately.
+// Events must not be recorded while the trace is being written.
+class ScheduleTracer
+{
+public:
+    ScheduleTracer();
+
+    ScheduleTracer(const ScheduleTracer&) = delete;
+    ScheduleTracer& operator=(const ScheduleTracer&) = delete;
+
+    void Begin(const char* name) { Record(name, 'B'); }
+    void End(const char* name) { Record(name, 'E'); }
+
+    std::size_t EventsCount() const;
+    void WriteChromeTrace(std::ostream& os) const;
+    void SaveChromeTrace(const std::string& fileName) const;
+
+private:
+    struct ThreadBuffer
+    {
+        std::size_t ThreadIndex = 0;
+        std::deque<ScheduleTraceEvent> Events;
+    };
+
+    void Record(const char* name, char phase);
+    ThreadBuffer& CurrentThreadBuffer();
+
+private:
+    std::uint64_t id_;
+    std::chrono::steady_clock::time_point beginTime_;
+    mutable std::mutex buffersMutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+
+// Begin and end events of a scope, does nothing if tracer is null
+class ScheduleTraceScope
+{
+public:
+    explicit ScheduleTraceScope(ScheduleTracer* pTracer, const char* name)
+        : pTracer_(pTracer)
+        , name_(name)
+    {
+        if(pTracer_ != nullptr)
+            pTracer_->Begin(name_);
+    }
+
+    ~ScheduleTraceScope()
+    {
+        if(pTracer_ != nullptr)
+            pTracer_->End(name_);
+    }
+
+    ScheduleTraceScope(const ScheduleTraceScope&) = delete;
+    ScheduleTraceScope& operator=(const ScheduleTraceScope&) = delete;
+
+private:
+    ScheduleTracer* pTracer_;
+    const char* name_;
+};
@@ -0,0 +1,296 @@
+#include "ScheduleGA.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+
+// defined by the build when the benchmark is linked with TBB
+#ifdef SCHEDULE_GA_BENCH_LIMIT_TBB
+#include <tbb/global_control.h>
+#endif
+
+
+// Anytime performance benchmark: best fitness reached at fixed wall-clock checkpoints
+// on a fixed suite of generated instances, over several seeds and thread counts.
+//
+//   bench_ScheduleGA run <result.csv> [seeds count] [threads: t,t,...]
+//   bench_ScheduleGA compare <baseline.csv> <candidate.csv> [tolerance percent]
+//
+// Result file has one line per instance, threads count and checkpoint with quartiles of the best fitness,
+// '-' marks quantiles falling on runs which had no evaluated individual yet at the checkpoint.
+// Compare prints median changes and exits with 1 if a candidate median is worse by more than the tolerance.
+
+struct BenchInstance
+{
+    const char* Name;
+    std::mt19937::result_type Seed;
+    std::size_t RequestsCount;
+    std::size_t ProfessorsCount;
+    std::size_t GroupsCount;
+};
+
+static constexpr BenchInstance BENCH_INSTANCES[] = {
+    {"small", 1, 100, 25, 30},
+    {"medium", 2, 300, 70, 90},
+    {"large", 3, 1000, 220, 300}
+};
+
+static constexpr int BENCH_CHECKPOINTS_MS[] = {100, 250, 500, 1000, 2000, 4000};
+
+static constexpr double INFINITE_FITNESS = std::numeric_limits<double>::infinity();
+
+
+static std::vector<SubjectRequest> MakeBenchRequests(const BenchInstance& instance)
+{
+    std::mt19937 gen(instance.Seed);
+    std::uniform_int_distribution<std::size_t> professorsDist(0, instance.ProfessorsCount - 1);
+    std::uniform_int_distribution<std::size_t> groupsDist(0, instance.GroupsCount - 1);
+    std::uniform_int_distribution<std::size_t> smallDist(1, 4);
+    std::bernoulli_distribution weekDayDist(0.7);
+
+    std::vector<SubjectRequest> requests;
+    for(std::size_t i = 0; i < instance.RequestsCount; ++i)
+    {
+        std::vector<bool> weekDays(DAYS_IN_SCHEDULE_WEEK);
+        for(std::size_t d = 0; d < weekDays.size(); ++d)
+            weekDays[d] = weekDayDist(gen);
+
+        std::vector<std::size_t> groups(smallDist(gen));
+        for(auto& g : groups)
+            g = groupsDist(gen);
+
+        std::vector<ClassroomAddress> classrooms(smallDist(gen) - 1);
+        for(auto& c : classrooms)
+            c = ClassroomAddress(smallDist(gen), smallDist(gen));
+
+        requests.emplace_back(i, professorsDist(gen), smallDist(gen), weekDays, groups, classrooms);
+    }
+
+    return requests;
+}
+
+// best fitness at every checkpoint, infinite if nothing was evaluated yet
+static std::vector<double> RunCheckpoints(const ScheduleData& data, int threadsCount, std::mt19937::result_type seed)
+{
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IterationsCount = std::numeric_limits<int>::max();
+    params.ThreadsCount = threadsCount;
+    params.SingleThreaded = threadsCount == 1;
+    params.Seed = seed;
+
+    ScheduleGA algo(params);
+    const auto beginTime = std::chrono::steady_clock::now();
+    auto handle = algo.StartAsync(data);
+
+    std::vector<double> results;
+    for(int checkpoint : BENCH_CHECKPOINTS_MS)
+    {
+        std::this_thread::sleep_until(beginTime + std::chrono::milliseconds(checkpoint));
+        const auto pBest = handle.Best();
+        results.emplace_back(pBest != nullptr ? static_cast<double>(pBest->Fitness) : INFINITE_FITNESS);
+    }
+
+    handle.Stop();
+    handle.Get();
+    return results;
+}
+
+// linear interpolation between closest ranks of sorted values
+static double Quantile(const std::vector<double>& sortedValues, double q)
+{
+    const double position = q * static_cast<double>(sortedValues.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(position);
+    const std::size_t upper = std::min(lower + 1, sortedValues.size() - 1);
+    if(std::isinf(sortedValues[upper]))
+        return sortedValues[upper];
+
+    return sortedValues[lower] + (sortedValues[upper] - sortedValues[lower]) * (position - static_cast<double>(lower));
+}
+
+static std::string FormatFitness(double fitness)
+{
+    if(std::isinf(fitness))
+        return "-";
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << fitness;
+    return os.str();
+}
+
+static std::vector<int> ParseThreadsCounts(const std::string& list)
+{
+    std::vector<int> threadsCounts;
+    std::istringstream is(list);
+    for(std::string item; std::getline(is, item, ',');)
+    {
+        const int threadsCount = std::stoi(item);
+        if(threadsCount <= 0)
+            throw std::invalid_argument("Invalid threads count: " + item);
+
+        threadsCounts.emplace_back(threadsCount);
+    }
+
+    return threadsCounts;
+}
+
+static int Run(const std::string& resultPath, int seedsCount, const std::vector<int>& threadsCounts)
+{
+    std::ofstream result(resultPath);
+    if(!result)
+        throw std::runtime_error("Unable to open " + resultPath);
+
+#ifndef SCHEDULE_GA_BENCH_LIMIT_TBB
+    if(std::ranges::any_of(threadsCounts, [](int threadsCount){ return threadsCount > 1; }))
+        std::cerr << "Warning: built without TBB, parallel phases are not limited by threads count" << std::endl;
+#endif
+
+    result << "instance,threads,checkpoint_ms,runs,q1,median,q3\n";
+    for(const auto& instance : BENCH_INSTANCES)
+    {
+        const ScheduleData data(MakeBenchRequests(instance), {});
+        for(int threadsCount : threadsCounts)
+        {
+#ifdef SCHEDULE_GA_BENCH_LIMIT_TBB
+            // generational mode runs its parallel phases on the shared pool of parallel algorithms
+            const tbb::global_control threadsLimit(tbb::global_control::max_allowed_parallelism, threadsCount);
+#endif
+            std::vector<std::vector<double>> checkpoints(std::size(BENCH_CHECKPOINTS_MS));
+            for(int seed = 1; seed <= seedsCount; ++seed)
+            {
+                std::cerr << instance.Name << ", threads: " << threadsCount << ", seed: " << seed << std::endl;
+
+                const auto runResults = RunCheckpoints(data, threadsCount, seed);
+                for(std::size_t c = 0; c < runResults.size(); ++c)
+                    checkpoints[c].emplace_back(runResults[c]);
+            }
+
+            for(std::size_t c = 0; c < checkpoints.size(); ++c)
+            {
+                std::ranges::sort(checkpoints[c]);
+                result << instance.Name << ',' << threadsCount << ',' << BENCH_CHECKPOINTS_MS[c] << ',' << seedsCount << ','
+                       << FormatFitness(Quantile(checkpoints[c], 0.25)) << ','
+                       << FormatFitness(Quantile(checkpoints[c], 0.5)) << ','
+                       << FormatFitness(Quantile(checkpoints[c], 0.75)) << '\n';
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+struct BenchResultLine
+{
+    std::string Key;
+    double Median = INFINITE_FITNESS;
+};
+
+static std::vector<BenchResultLine> ReadResult(const std::string& path)
+{
+    std::ifstream is(path);
+    if(!is)
+        throw std::runtime_error("Unable to open " + path);
+
+    std::vector<BenchResultLine> lines;
+    std::string line;
+    std::getline(is, line);
+    while(std::getline(is, line))
+    {
+        std::vector<std::string> fields;
+        std::istringstream lineStream(line);
+        for(std::string field; std::getline(lineStream, field, ',');)
+            fields.emplace_back(field);
+
+        if(fields.size() != 7)
+            throw std::runtime_error("Invalid line in " + path + ": " + line);
+
+        lines.push_back(BenchResultLine{
+            .Key = fields[0] + ',' + fields[1] + ',' + fields[2],
+            .Median = fields[5] == "-" ? INFINITE_FITNESS : std::stod(fields[5])
+        });
+    }
+
+    return lines;
+}
+
+static int Compare(const std::string& baselinePath, const std::string& candidatePath, double tolerancePercent)
+{
+    const auto baseline = ReadResult(baselinePath);
+    const auto candidate = ReadResult(candidatePath);
+
+    bool regressed = false;
+    std::cout << "instance,threads,checkpoint_ms,baseline,candidate,change_percent\n";
+    for(const auto& baselineLine : baseline)
+    {
+        const auto it = std::ranges::find(candidate, baselineLine.Key, &BenchResultLine::Key);
+        if(it == candidate.end())
+            continue;
+
+        std::string change = "-";
+        if(!std::isinf(baselineLine.Median) && !std::isinf(it->Median))
+        {
+            const double percent = baselineLine.Median > 0.0
+                ? (it->Median - baselineLine.Median) * 100.0 / baselineLine.Median
+                : (it->Median > 0.0 ? INFINITE_FITNESS : 0.0);
+
+            std::ostringstream os;
+            os << std::showpos << std::fixed << std::setprecision(1) << percent;
+            change = os.str();
+            regressed = regressed || percent > tolerancePercent;
+        }
+        else if(std::isinf(it->Median) && !std::isinf(baselineLine.Median))
+        {
+            regressed = true;
+        }
+
+        std::cout << baselineLine.Key << ',' << FormatFitness(baselineLine.Median) << ','
+                  << FormatFitness(it->Median) << ',' << change << '\n';
+    }
+
+    if(regressed)
+        std::cout << "Regression: candidate median is worse by more than " << tolerancePercent << "%" << std::endl;
+
+    return regressed ? 1 : 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        const std::string mode = argc > 1 ? argv[1] : "";
+        if(mode == "run" && argc >= 3 && argc <= 5)
+        {
+            const int seedsCount = argc > 3 ? std::stoi(argv[3]) : 5;
+            if(seedsCount <= 0)
+                throw std::invalid_argument("Invalid seeds count: must be greater than zero");
+
+            const auto threadsCounts = argc > 4
+                ? ParseThreadsCounts(argv[4])
+                : std::vector<int>{1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u))};
+
+            return Run(argv[2], seedsCount, threadsCounts);
+        }
+
+        if(mode == "compare" && argc >= 4 && argc <= 5)
+            return Compare(argv[2], argv[3], argc > 4 ? std::stod(argv[4]) : 5.0);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " run <result.csv> [seeds count] [threads: t,t,...]\n"
+              << "       " << argv[0] << " compare <baseline.csv> <candidate.csv> [tolerance percent]" << std::endl;
+    return 2;
+}
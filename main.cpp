@@ -240,6 +240,15 @@ int main()
 	Print(bestIndividual, data);
 	std::cout << "Best: " << bestIndividual.Evaluate() << '\n';
 	std::cout << "Time: " << std::chrono::duration_cast<std::chrono::milliseconds>(stat.Time).count() << "ms.\n";
+	std::cout << "Evaluations per second: " << stat.EvaluationsPerSecond << '\n';
+	std::cout << "Memory: " << stat.Memory.TotalBytes() << " bytes (population: " << stat.Memory.PopulationBytes <<
+		", data: " << stat.Memory.ScheduleDataBytes << ", scratch per thread: " << stat.Memory.ScratchBytesPerThread << ")\n";
+	if constexpr(SCHEDULE_COUNTERS_ENABLED)
+	{
+		for(std::size_t c = 0; c < stat.Counters.size(); ++c)
+			std::cout << ScheduleCounterName(static_cast<ScheduleCounter>(c)) << ": " << stat.Counters[c] << '\n';
+	}
+
 	std::cout.flush();
 	return 0;
 }
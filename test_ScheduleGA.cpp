@@ -2,6 +2,162 @@
 
 #include "ScheduleCommon.h"
 #include "ScheduleIndividual.h"
+#include "ScheduleGA.h"
+#include "ScheduleSA.h"
+#include "ScheduleIslands.h"
+#include "ScheduleBatch.h"
+#include "ScheduleTrace.h"
+#include "ScheduleExport.h"
+#include "ScheduleDaemon.h"
+
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include <csignal>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include <range/v3/all.hpp>
+
+
+static std::vector<SubjectRequest> MakeRandomRequests(std::size_t count, std::mt19937& gen)
+{
+    std::uniform_int_distribution<std::size_t> professorsDist(0, count / 4);
+    std::uniform_int_distribution<std::size_t> groupsDist(0, count / 3);
+    std::uniform_int_distribution<std::size_t> smallDist(1, 4);
+    std::bernoulli_distribution weekDayDist(0.7);
+
+    std::vector<SubjectRequest> requests;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        std::vector<bool> weekDays(DAYS_IN_SCHEDULE_WEEK);
+        for(std::size_t d = 0; d < weekDays.size(); ++d)
+            weekDays[d] = weekDayDist(gen);
+
+        std::vector<std::size_t> groups(smallDist(gen));
+        for(auto& g : groups)
+            g = groupsDist(gen);
+
+        std::vector<ClassroomAddress> classrooms(smallDist(gen) - 1);
+        for(auto& c : classrooms)
+            c = ClassroomAddress(smallDist(gen), smallDist(gen));
+
+        requests.emplace_back(i, professorsDist(gen), smallDist(gen), weekDays, groups, classrooms);
+    }
+
+    return requests;
+}
+
+
+// Sorting evaluation which was used before day masks kernels, scores must stay identical
+template<typename Calendar>
+static std::size_t ReferenceProfessorLessonsGaps(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                                const std::vector<std::size_t>& professorRequests)
+{
+    auto toLesson = [&](std::size_t r){ return scheduleChromosomes.Lesson(r); };
+    auto inSameDay = [](std::size_t lhs, std::size_t rhs) { return Calendar::Day(lhs) == Calendar::Day(rhs); };
+
+    std::vector<std::size_t> lessons = professorRequests
+        | ranges::view::transform(toLesson)
+        | ranges::to<std::vector<std::size_t>>
+        | ranges::action::sort;
+
+    std::size_t maxLessonsGaps = 0;
+    for(auto day : lessons | ranges::view::group_by(inSameDay) | ranges::view::common)
+    {
+        maxLessonsGaps = std::max(maxLessonsGaps,
+                                  std::inner_product(std::next(day.begin()), day.end(), day.begin(),
+                                                     std::size_t{0}, std::plus<>{}, std::minus<>{}));
+    }
+
+    return maxLessonsGaps;
+}
+
+template<typename Calendar>
+static GroupEvaluation ReferenceGroupEvaluation(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                     const BasicScheduleData<Calendar>& scheduleData,
+                                     const std::vector<std::size_t>& groupRequests)
+{
+    auto toLesson = [&](std::size_t r){ return scheduleChromosomes.Lesson(r); };
+    const auto& requests = scheduleData.SubjectRequests();
+
+    std::vector<std::pair<std::size_t, std::size_t>> lessons = ranges::view::zip(groupRequests | ranges::view::transform(toLesson),
+                                                                                 groupRequests)
+        | ranges::to<std::vector<std::pair<std::size_t, std::size_t>>>
+        | ranges::action::sort;
+
+    GroupEvaluation result;
+    for(auto day : lessons
+        | ranges::view::filter([](auto&& item){ return item.first != std::numeric_limits<std::size_t>::max(); })
+        | ranges::view::group_by([](auto&& lhs, auto&& rhs) { return Calendar::Day(lhs.first) == Calendar::Day(rhs.first); })
+        | ranges::view::common)
+    {
+        result.DayComplexity = std::max(result.DayComplexity,
+                                        std::inner_product(day.begin(), day.end(), day.begin(),
+                                                           std::size_t{0},
+                                                           std::plus<>{},
+                                                           [&](auto&& lhs, auto&& rhs){ return Calendar::DayLesson(lhs.first) * requests.at(rhs.second).Complexity(); }));
+
+        result.LessonsGaps = std::max(result.LessonsGaps,
+                                      std::inner_product(std::next(day.begin()), day.end(), day.begin(),
+                                                         std::size_t{0},
+                                                         std::plus<>{},
+                                                         [](auto&& lhs, auto&& rhs){ return lhs.first - rhs.first; }));
+
+        result.BuildingsChanges = std::max(result.BuildingsChanges,
+                                           std::inner_product(std::next(day.begin()), day.end(), day.begin(),
+                                                              std::size_t{0},
+                                                              std::plus<>{},
+                                                              [&](auto&& lhs, auto&& rhs) -> std::size_t
+        {
+            const std::size_t lhsBuilding = scheduleChromosomes.Classroom(lhs.second).Building;
+            const std::size_t rhsBuilding = scheduleChromosomes.Classroom(rhs.second).Building;
+            return !(lhsBuilding == NO_BUILDING || rhsBuilding == NO_BUILDING || lhsBuilding == rhsBuilding);
+        }));
+    }
+
+    return result;
+}
+
+template<typename Calendar>
+static std::size_t ReferenceEvaluate(const BasicScheduleChromosomes<Calendar>& scheduleChromosomes,
+                                     const BasicScheduleData<Calendar>& scheduleData)
+{
+    std::size_t maxBuildingsDayEval = 0;
+    std::size_t maxDayComplexity = 0;
+    std::size_t maxLessonsGapsForGroupsSum = 0;
+    std::size_t maxLessonsGapsForProfessorsSum = 0;
+
+    for(auto&& professorRequests : scheduleData.ProfessorsRequests())
+    {
+        maxLessonsGapsForProfessorsSum = std::max(maxLessonsGapsForProfessorsSum,
+                                                  ReferenceProfessorLessonsGaps(scheduleChromosomes, professorRequests));
+    }
+
+    for(auto&& groupRequests : scheduleData.GroupsRequests())
+    {
+        const GroupEvaluation group = ReferenceGroupEvaluation(scheduleChromosomes, scheduleData, groupRequests);
+        maxLessonsGapsForGroupsSum = std::max(maxLessonsGapsForGroupsSum, group.LessonsGaps);
+        maxDayComplexity = std::max(maxDayComplexity, group.DayComplexity);
+        maxBuildingsDayEval = std::max(maxBuildingsDayEval, group.BuildingsChanges);
+    }
+
+    const std::size_t notPlacedLessons = std::ranges::count(scheduleChromosomes.Lessons(), std::numeric_limits<std::size_t>::max());
+    const std::size_t notPlacedClassrooms = std::ranges::count(scheduleChromosomes.Classrooms(), ClassroomAddress::NoClassroom());
+
+    return maxLessonsGapsForGroupsSum * 3 +
+        maxLessonsGapsForProfessorsSum * 2 +
+        maxDayComplexity * 4 +
+        maxBuildingsDayEval * 64 +
+        notPlacedLessons * 100 + notPlacedClassrooms * 100;
+}
 
 
 TEST_CASE("Check if groups or professors or classrooms intersects", "[ScheduleChromosomes]")
@@ -82,3 +238,1608 @@ TEST_CASE("Crossover works", "[ScheduleChromosomes]")
     REQUIRE(second.Lesson(0) == 0);
     REQUIRE(second.Classroom(0) == ClassroomAddress{0,3});
 }
+
+TEST_CASE("Conflict graph connects requests with common professors or groups", "[ScheduleData]")
+{
+    const std::vector weekDays{true, true, true, true, true, true};
+    SECTION("Dense conflict graph")
+    {
+        const std::vector requests {
+            // [id, professor, complexity, weekDays, groups, classrooms]
+            SubjectRequest(0, 1, 1, weekDays, {0, 1, 2}, {}),
+            SubjectRequest(1, 2, 1, weekDays, {2, 3}, {}),
+            SubjectRequest(2, 1, 1, weekDays, {4, 5}, {}),
+            SubjectRequest(3, 3, 1, weekDays, {6}, {})
+        };
+        const ScheduleData data{requests, {}};
+
+        REQUIRE(data.ConflictGraph().IsDense());
+        REQUIRE(data.RequestsConflicts(0, 0));
+        REQUIRE(data.RequestsConflicts(0, 1));
+        REQUIRE(data.RequestsConflicts(1, 0));
+        REQUIRE(data.RequestsConflicts(0, 2));
+        REQUIRE_FALSE(data.RequestsConflicts(1, 2));
+        REQUIRE_FALSE(data.RequestsConflicts(0, 3));
+        REQUIRE_FALSE(data.RequestsConflicts(3, 2));
+    }
+    SECTION("Sparse conflict graph")
+    {
+        std::vector<SubjectRequest> requests;
+        for(std::size_t r = 0; r <= DENSE_CONFLICT_GRAPH_MAX_SIZE; ++r)
+            requests.emplace_back(r, r % 100, 1, weekDays, std::vector<std::size_t>{r}, std::vector<ClassroomAddress>{});
+
+        const ScheduleData data{requests, {}};
+
+        REQUIRE_FALSE(data.ConflictGraph().IsDense());
+        REQUIRE(data.RequestsConflicts(5, 5));
+        REQUIRE(data.RequestsConflicts(5, 105));
+        REQUIRE(data.RequestsConflicts(4005, 5));
+        REQUIRE_FALSE(data.RequestsConflicts(5, 6));
+        REQUIRE_FALSE(data.RequestsConflicts(4006, 5));
+    }
+}
+
+TEST_CASE("Free lessons exclude intersecting and not requested lessons", "[ScheduleChromosomes]")
+{
+    const std::vector requests {
+        // [id, professor, complexity, weekDays, groups, classrooms]
+        SubjectRequest(0, 1, 1, {true, false, false, false, false, true}, {0}, {{0, 1}}),
+        SubjectRequest(1, 1, 1, {true, true, true, true, true, true}, {1}, {{0, 2}}),
+        SubjectRequest(2, 2, 1, {true, true, true, true, true, true}, {0}, {{0, 3}}),
+        SubjectRequest(3, 3, 1, {true, true, true, true, true, true}, {2}, {{0, 1}}),
+        SubjectRequest(4, 4, 1, {true, true, true, true, true, true}, {3}, {{0, 4}})
+    };
+    const ScheduleData data{requests, {}};
+    const ScheduleChromosomes sat{{0, 1, 2, 3, 4},
+                                  {{0,1}, {0,2}, {0,3}, {0,1}, {0,4}}};
+
+    const LessonsMask freeLessons = sat.FreeLessons(data, 0);
+
+    // requested days are monday and saturday of both weeks without late saturday lessons
+    REQUIRE(freeLessons.Count() == 4 * MAX_LESSONS_PER_DAY - 6 - 4);
+    REQUIRE_FALSE(freeLessons.Test(0));
+    REQUIRE_FALSE(freeLessons.Test(1));
+    REQUIRE_FALSE(freeLessons.Test(2));
+    REQUIRE_FALSE(freeLessons.Test(3));
+    REQUIRE(freeLessons.Test(4));
+    REQUIRE_FALSE(freeLessons.Test(MAX_LESSONS_PER_DAY));
+    REQUIRE(freeLessons.Test(5 * MAX_LESSONS_PER_DAY + 3));
+    REQUIRE_FALSE(freeLessons.Test(5 * MAX_LESSONS_PER_DAY + 4));
+
+    REQUIRE(freeLessons.NthLesson(0) == 4);
+    REQUIRE(freeLessons.NthLesson(freeLessons.Count() - 1) == 11 * MAX_LESSONS_PER_DAY + 3);
+}
+
+TEST_CASE("Requests static info is precomputed", "[ScheduleData]")
+{
+    const std::vector requests {
+        // [id, professor, complexity, weekDays, groups, classrooms]
+        SubjectRequest(0, 1, 1, {false, true, false, false, false, false}, {0}, {}),
+        SubjectRequest(1, 2, 1, {false, false, false, false, false, true}, {1}, {})
+    };
+    const ScheduleData data{requests, {SubjectWithAddress(1, 5 * MAX_LESSONS_PER_DAY)}};
+
+    REQUIRE_FALSE(data.RequestHasLockedLesson(0));
+    REQUIRE(data.RequestHasLockedLesson(1));
+
+    REQUIRE(data.RequestedLessons(0).Count() == 2 * MAX_LESSONS_PER_DAY);
+    REQUIRE(data.RequestedLessons(0).Test(MAX_LESSONS_PER_DAY));
+    REQUIRE(data.RequestedLessons(0).Test(7 * MAX_LESSONS_PER_DAY + 6));
+    REQUIRE_FALSE(data.RequestedLessons(0).Test(0));
+
+    REQUIRE(data.RequestedLessons(1).Count() == 2 * (MAX_LESSONS_PER_DAY - 3));
+    REQUIRE_FALSE(data.RequestedLessons(1).Test(5 * MAX_LESSONS_PER_DAY + 4));
+}
+
+TEST_CASE("Locked lessons outside of calendar are rejected", "[ScheduleData]")
+{
+    std::mt19937 gen(40);
+    const auto requests = MakeRandomRequests(20, gen);
+
+    REQUIRE_THROWS_AS(ScheduleData(requests, {SubjectWithAddress(0, 500)}), std::out_of_range);
+    REQUIRE_THROWS_AS(ScheduleData(requests, {SubjectWithAddress(0, DefaultScheduleCalendar::MaxLessonsCount)}), std::out_of_range);
+
+    const ScheduleData data{requests, {SubjectWithAddress(0, DefaultScheduleCalendar::MaxLessonsCount - 1)}};
+    const ScheduleChromosomes chromosomes(data);
+    REQUIRE(chromosomes.Lesson(0) == DefaultScheduleCalendar::MaxLessonsCount - 1);
+    REQUIRE(Evaluate(chromosomes, data) == EvaluateDetailed(chromosomes, data).Fitness);
+
+    // graph coloring places locked lessons into its per-lesson tables first
+    std::mt19937 coloringGen(44);
+    const ScheduleChromosomes colored(data, coloringGen);
+    REQUIRE(colored.Lesson(0) == DefaultScheduleCalendar::MaxLessonsCount - 1);
+    REQUIRE(Evaluate(colored, data) == EvaluateDetailed(colored, data).Fitness);
+}
+
+TEST_CASE("Calendar lookup tables are built at compile time", "[ScheduleCalendar]")
+{
+    static_assert(DefaultScheduleCalendar::MaxLessonsCount == 84);
+    static_assert(!DefaultScheduleCalendar::IsLateLessonInSaturday(38));
+    static_assert(DefaultScheduleCalendar::IsLateLessonInSaturday(39));
+    static_assert(DefaultScheduleCalendar::IsLateLessonInSaturday(41));
+    static_assert(!DefaultScheduleCalendar::IsLateLessonInSaturday(42));
+    static_assert(DefaultScheduleCalendar::IsLateLessonInSaturday(81));
+    static_assert(DefaultScheduleCalendar::IsLateLessonInSaturday(83));
+    static_assert(std::ranges::count(DefaultScheduleCalendar::LateSaturdayLessonsTable, true) == 6);
+
+    static_assert(EightLessonsScheduleCalendar::MaxLessonsCount == 96);
+    static_assert(EightLessonsScheduleCalendar::IsLateLessonInSaturday(5 * 8 + 4));
+    static_assert(std::ranges::count(EightLessonsScheduleCalendar::LateSaturdayLessonsTable, true) == 8);
+
+    static_assert(OneWeekScheduleCalendar::MaxLessonsCount == 42);
+    static_assert(std::ranges::count(OneWeekScheduleCalendar::LateSaturdayLessonsTable, true) == 3);
+}
+
+TEST_CASE("Genetic algorithm works with other calendars", "[ScheduleGA]")
+{
+    const std::vector weekDays{true, true, true, true, true, true};
+    const std::vector requests {
+        // [id, professor, complexity, weekDays, groups, classrooms]
+        SubjectRequest(0, 1, 1, weekDays, {0, 1, 2}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(1, 2, 1, weekDays, {1, 2, 3}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(2, 1, 1, weekDays, {4, 5, 6}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(3, 4, 1, weekDays, {7, 8, 9}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(4, 5, 1, weekDays, {10},      {{0, 1}, {0, 2}, {0, 3}})
+    };
+    const ScheduleGAParams params{
+        .IndividualsCount = 20,
+        .IterationsCount = 10,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50
+    };
+
+    const BasicScheduleData<OneWeekScheduleCalendar> data{requests, {}};
+    BasicScheduleGA<OneWeekScheduleCalendar> algo(params);
+    algo.Start(data);
+
+    const auto& best = algo.Individuals().front().Chromosomes();
+    for(std::size_t r = 0; r < requests.size(); ++r)
+    {
+        REQUIRE(best.Lesson(r) < OneWeekScheduleCalendar::MaxLessonsCount);
+        REQUIRE_FALSE(OneWeekScheduleCalendar::IsLateLessonInSaturday(best.Lesson(r)));
+    }
+}
+
+TEST_CASE("Steady-state genetic algorithm works", "[ScheduleGA]")
+{
+    const std::vector weekDays{true, true, true, true, true, true};
+    const std::vector requests {
+        // [id, professor, complexity, weekDays, groups, classrooms]
+        SubjectRequest(0, 1, 1, weekDays, {0, 1, 2}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(1, 2, 1, weekDays, {1, 2, 3}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(2, 1, 1, weekDays, {4, 5, 6}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(3, 4, 1, weekDays, {7, 8, 9}, {{0, 1}, {0, 2}, {0, 3}}),
+        SubjectRequest(4, 5, 1, weekDays, {10},      {{0, 1}, {0, 2}, {0, 3}})
+    };
+    const ScheduleData data{requests, {}};
+    const ScheduleGAParams params{
+        .IndividualsCount = 20,
+        .IterationsCount = 10,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50,
+        .Mode = ScheduleGAMode::SteadyState,
+        .TournamentSize = 3,
+        .ThreadsCount = 2
+    };
+
+    std::random_device randomDevice;
+    const std::size_t initialFitness = ScheduleIndividual(randomDevice, &data).Evaluate();
+
+    ScheduleGA algo(params);
+    const auto statistics = algo.Start(data);
+
+    REQUIRE(statistics.EvaluationsCount == 200);
+    REQUIRE(algo.Individuals().size() == 20);
+    REQUIRE(algo.Individuals().front().Evaluate() <= initialFitness);
+}
+
+TEST_CASE("Incremental evaluation matches Evaluate", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(42);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleChromosomes chromosomes(data);
+    IncrementalEvaluator<DefaultScheduleCalendar> evaluator(chromosomes, data);
+    REQUIRE(evaluator.Value() == Evaluate(chromosomes, data));
+
+    std::uniform_int_distribution<std::size_t> requestsDist(0, requests.size() - 1);
+    std::uniform_int_distribution<std::size_t> lessonsDist(0, MAX_LESSONS_COUNT);
+    for(int move = 0; move < 300; ++move)
+    {
+        const std::size_t r = requestsDist(gen);
+        const std::size_t oldLesson = chromosomes.Lesson(r);
+        const ClassroomAddress oldClassroom = chromosomes.Classroom(r);
+
+        const std::size_t lesson = lessonsDist(gen);
+        chromosomes.Lesson(r) = lesson < MAX_LESSONS_COUNT ? lesson : std::numeric_limits<std::size_t>::max();
+
+        const auto& classrooms = data.SubjectRequests().at(r).Classrooms();
+        if(!classrooms.empty())
+            chromosomes.Classroom(r) = classrooms.at(lesson % classrooms.size());
+
+        evaluator.Update(chromosomes, r, oldLesson, oldClassroom);
+        REQUIRE(evaluator.Value() == Evaluate(chromosomes, data));
+    }
+}
+
+TEST_CASE("Local search does not worsen individual", "[ScheduleIndividual]")
+{
+    std::mt19937 gen(7);
+    const auto requests = MakeRandomRequests(80, gen);
+    const ScheduleData data{requests, {}};
+
+    std::random_device randomDevice;
+    ScheduleIndividual individual(randomDevice, &data);
+    const std::size_t initialFitness = individual.Evaluate();
+
+    individual.LocalSearch(200);
+    REQUIRE(individual.Evaluate() <= initialFitness);
+    REQUIRE(individual.Evaluate() == Evaluate(individual.Chromosomes(), data));
+}
+
+TEST_CASE("Simulated annealing works", "[ScheduleSA]")
+{
+    std::mt19937 gen(3);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    std::random_device randomDevice;
+    const std::size_t initialFitness = ScheduleIndividual(randomDevice, &data).Evaluate();
+
+    const ScheduleSAParams params{
+        .ChainsCount = 3,
+        .IterationsCount = 500,
+        .InitialTemperature = 10.0,
+        .FinalTemperature = 0.1,
+        .TabuTenure = 8
+    };
+    ScheduleSA algo(params);
+    const auto statistics = algo.Start(data);
+
+    REQUIRE(statistics.EvaluationsCount <= 3 * 500);
+    REQUIRE(algo.Individuals().size() == 3);
+    REQUIRE(algo.Individuals().front().Evaluate() <= initialFitness);
+    REQUIRE(algo.Individuals().front().Evaluate() == Evaluate(algo.Individuals().front().Chromosomes(), data));
+}
+
+TEST_CASE("Islands exchange migrants and return the global best", "[ScheduleIslands]")
+{
+    std::mt19937 gen(11);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleIslandsParams params{
+        .IslandsCount = 3,
+        .MigrantsCapacity = 2,
+        .GAParams = {
+            .IndividualsCount = 20,
+            .IterationsCount = 20,
+            .SelectionCount = 5,
+            .CrossoverCount = 3,
+            .MutationChance = 50,
+            .MigrationInterval = 5
+        }
+    };
+
+    // thread pool of parallel algorithms is already running when islands are forked
+    ScheduleGA(params.GAParams).Start(data);
+
+    const auto result = RunScheduleIslands(data, params);
+    REQUIRE(result.IslandsFitness.size() == 3);
+    REQUIRE(result.BestFitness == std::ranges::min(result.IslandsFitness));
+    REQUIRE(result.BestFitness == Evaluate(result.Best, data));
+}
+
+// pid of a child process of this process, found through /proc (Linux only)
+static std::optional<pid_t> FindChildProcess()
+{
+    for(const auto& entry : std::filesystem::directory_iterator("/proc"))
+    {
+        std::ifstream stat(entry.path() / "stat");
+        std::string line;
+        if(!std::getline(stat, line) || line.rfind(')') == std::string::npos)
+            continue;
+
+        // "<pid> (<comm>) <state> <ppid> ..."
+        std::istringstream fields(line.substr(line.rfind(')') + 1));
+        std::string state;
+        pid_t parent = 0;
+        if(fields >> state >> parent && parent == getpid())
+            return static_cast<pid_t>(std::stoi(entry.path().filename().string()));
+    }
+
+    return std::nullopt;
+}
+
+TEST_CASE("Islands survive a failed island", "[ScheduleIslands]")
+{
+    std::mt19937 gen(33);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleIslandsParams params{
+        .IslandsCount = 3,
+        .MigrantsCapacity = 2,
+        .GAParams = {
+            .IndividualsCount = 30,
+            .IterationsCount = 2000,
+            .SelectionCount = 5,
+            .CrossoverCount = 3,
+            .MutationChance = 50,
+            .MigrationInterval = 5
+        }
+    };
+
+    // kills the first island process which shows up
+    std::atomic<bool> killed = false;
+    std::thread killer([&]
+    {
+        for(int attempt = 0; attempt < 10000 && !killed; ++attempt)
+        {
+            if(const auto child = FindChildProcess(); child && kill(*child, SIGKILL) == 0)
+                killed = true;
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    const auto result = RunScheduleIslands(data, params);
+    killer.join();
+
+    REQUIRE(killed);
+    REQUIRE(result.FailedIslands.size() == 1);
+    REQUIRE(result.IslandsFitness.size() == 3);
+    REQUIRE(result.IslandsFitness[result.FailedIslands.front()] == std::numeric_limits<std::size_t>::max());
+    REQUIRE(result.BestFitness == std::ranges::min(result.IslandsFitness));
+    REQUIRE(result.BestFitness == Evaluate(result.Best, data));
+}
+
+TEST_CASE("Asynchronous run publishes improving snapshots", "[ScheduleGA]")
+{
+    std::mt19937 gen(5);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    for(auto mode : {ScheduleGAMode::Generational, ScheduleGAMode::SteadyState})
+    {
+        const ScheduleGAParams params{
+            .IndividualsCount = 20,
+            .IterationsCount = 15,
+            .SelectionCount = 5,
+            .CrossoverCount = 3,
+            .MutationChance = 50,
+            .Mode = mode,
+            .ThreadsCount = 2
+        };
+
+        std::mutex progressMutex;
+        std::vector<ScheduleGAProgress> progress;
+        ScheduleGA algo(params);
+        auto handle = algo.StartAsync(data, [&](const ScheduleGAProgress& p)
+        {
+            std::lock_guard lock(progressMutex);
+            progress.emplace_back(p);
+        });
+
+        std::size_t lastSeenFitness = std::numeric_limits<std::size_t>::max();
+        while(!handle.Ready())
+        {
+            if(auto pBest = handle.Best())
+            {
+                REQUIRE(pBest->Fitness <= lastSeenFitness);
+                lastSeenFitness = pBest->Fitness;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        handle.Get();
+        const auto pBest = handle.Best();
+        REQUIRE(pBest != nullptr);
+        REQUIRE(pBest->Fitness == Evaluate(pBest->Chromosomes, data));
+        REQUIRE(pBest->Fitness <= algo.Individuals().front().Evaluate());
+        REQUIRE(progress.size() == 15);
+        // snapshot keeps the best individual ever found, steady-state workers may also publish it after the last report
+        REQUIRE(std::ranges::min(progress, {}, &ScheduleGAProgress::BestFitness).BestFitness >= pBest->Fitness);
+    }
+}
+
+TEST_CASE("Asynchronous run can be stopped early", "[ScheduleGA]")
+{
+    std::mt19937 gen(6);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleGAParams params{
+        .IndividualsCount = 20,
+        .IterationsCount = 1000000,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50
+    };
+
+    ScheduleGA algo(params);
+    auto handle = algo.StartAsync(data);
+    handle.Stop();
+
+    const auto statistics = handle.Get();
+    REQUIRE(statistics.EvaluationsCount < 1000000);
+    REQUIRE(algo.Individuals().size() == 20);
+}
+
+TEST_CASE("Batch solves every instance", "[ScheduleBatch]")
+{
+    std::mt19937 gen(9);
+    std::vector<ScheduleData> datas;
+    for(std::size_t requestsCount : {10, 60, 25, 40})
+        datas.emplace_back(MakeRandomRequests(requestsCount, gen), std::vector<SubjectWithAddress>{});
+
+    std::vector<const ScheduleData*> instances;
+    for(const auto& data : datas)
+        instances.emplace_back(&data);
+
+    const ScheduleBatchParams params{
+        .GAParams = {
+            .IndividualsCount = 20,
+            .IterationsCount = 10,
+            .SelectionCount = 5,
+            .CrossoverCount = 3,
+            .MutationChance = 50
+        },
+        .ParallelRequestsThreshold = 30
+    };
+
+    std::vector<std::pair<std::size_t, std::size_t>> completed;
+    const auto results = SolveScheduleBatch(instances, params, [&](std::size_t instance, const ScheduleBatchResult& result)
+    {
+        completed.emplace_back(instance, result.BestFitness);
+    });
+
+    REQUIRE(results.size() == datas.size());
+    REQUIRE(completed.size() == datas.size());
+    for(auto [instance, fitness] : completed)
+        REQUIRE(results.at(instance).BestFitness == fitness);
+
+    for(std::size_t i = 0; i < datas.size(); ++i)
+    {
+        REQUIRE(results[i].Best.Lessons().size() == datas[i].SubjectRequests().size());
+        REQUIRE(results[i].BestFitness == Evaluate(results[i].Best, datas[i]));
+        REQUIRE(results[i].Statistics.EvaluationsCount > 0);
+    }
+}
+
+TEST_CASE("Independent faculties are split into components", "[ScheduleData]")
+{
+    std::mt19937 gen(13);
+    std::vector<SubjectRequest> requests;
+    std::vector<SubjectWithAddress> lockedLessons;
+    for(std::size_t faculty = 0; faculty < 3; ++faculty)
+    {
+        // every faculty has its own professors, groups and buildings
+        for(const auto& request : MakeRandomRequests(30, gen))
+        {
+            std::vector<bool> weekDays(DAYS_IN_SCHEDULE_WEEK, true);
+            std::vector<std::size_t> groups = request.Groups();
+            for(auto& g : groups)
+                g += faculty * 1000;
+
+            std::vector<ClassroomAddress> classrooms = request.Classrooms();
+            for(auto& c : classrooms)
+                c.Building += faculty * 1000;
+
+            requests.emplace_back(faculty * 1000 + request.ID(), faculty * 1000 + request.Professor(),
+                                  request.Complexity(), weekDays, groups, classrooms);
+        }
+
+        lockedLessons.emplace_back(faculty * 1000, 0);
+    }
+
+    const ScheduleData data{requests, lockedLessons};
+
+    std::vector<std::size_t> requestsComponents(requests.size());
+    for(std::size_t c = 0; c < data.Components().size(); ++c)
+    {
+        for(std::size_t r : data.Components()[c])
+            requestsComponents[r] = c;
+    }
+
+    for(std::size_t r = 0; r < requests.size(); ++r)
+    {
+        for(std::size_t n = 0; n < requests.size(); ++n)
+        {
+            if(data.RequestsConflicts(r, n))
+                REQUIRE(requestsComponents[r] == requestsComponents[n]);
+
+            // requests of different faculties are never joined
+            if(requestsComponents[r] == requestsComponents[n])
+                REQUIRE(data.SubjectRequests()[r].ID() / 1000 == data.SubjectRequests()[n].ID() / 1000);
+        }
+    }
+
+    const auto componentData = data.ComponentData(data.Components().front());
+    REQUIRE(componentData.SubjectRequests().size() == data.Components().front().size());
+    REQUIRE(componentData.LockedLessons().size() <= 1);
+
+    const ScheduleBatchParams params{
+        .GAParams = {
+            .IndividualsCount = 20,
+            .IterationsCount = 10,
+            .SelectionCount = 5,
+            .CrossoverCount = 3,
+            .MutationChance = 50
+        }
+    };
+
+    const auto result = SolveScheduleComponents(data, params);
+    REQUIRE(result.ComponentsCount == data.Components().size());
+    REQUIRE(result.ComponentsCount >= 3);
+    REQUIRE(result.BestFitness == Evaluate(result.Best, data));
+
+    // merged statistics describe the whole problem
+    REQUIRE(result.Statistics.BestEvaluation.Fitness == result.BestFitness);
+    REQUIRE(result.Statistics.Memory.IndividualsCount == 20);
+    REQUIRE(result.Statistics.Memory.IndividualBytes > ScheduleGA(params.GAParams).ProjectMemory(componentData, 20).IndividualBytes);
+    REQUIRE(result.Statistics.Memory.PopulationBytes == 20 * result.Statistics.Memory.IndividualBytes);
+#ifdef SCHEDULE_GA_COUNTERS
+    REQUIRE(result.Statistics.Counters[static_cast<std::size_t>(ScheduleCounter::CrossoverCalls)] == result.ComponentsCount * 10 * 3);
+#endif
+}
+
+TEST_CASE("Operators counters are collected from all threads", "[ScheduleCounters]")
+{
+    std::mt19937 gen(17);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleGAParams params{
+        .IndividualsCount = 20,
+        .IterationsCount = 10,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50
+    };
+
+    ScheduleGA algo(params);
+    const auto statistics = algo.Start(data);
+    const auto counter = [&](ScheduleCounter c) { return statistics.Counters.at(static_cast<std::size_t>(c)); };
+
+    if constexpr(SCHEDULE_COUNTERS_ENABLED)
+    {
+        REQUIRE(counter(ScheduleCounter::CrossoverCalls) == 10 * 3);
+        REQUIRE(counter(ScheduleCounter::CrossoverRejections) <= counter(ScheduleCounter::CrossoverCalls));
+        REQUIRE(counter(ScheduleCounter::ChangeLessonCalls) + counter(ScheduleCounter::ChangeClassroomCalls) > 0);
+        REQUIRE(counter(ScheduleCounter::ChangeLessonFailures) <= counter(ScheduleCounter::ChangeLessonCalls));
+        REQUIRE(counter(ScheduleCounter::ChangeClassroomFailures) <= counter(ScheduleCounter::ChangeClassroomCalls));
+        REQUIRE(counter(ScheduleCounter::ConflictCheckIterations) > 0);
+    }
+    else
+    {
+        REQUIRE(std::ranges::all_of(statistics.Counters, [](auto value) { return value == 0; }));
+    }
+}
+
+TEST_CASE("Tracer records balanced phases of every generation", "[ScheduleTrace]")
+{
+    std::mt19937 gen(19);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleGAParams params{
+        .IndividualsCount = 20,
+        .IterationsCount = 5,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50
+    };
+
+    ScheduleTracer tracer;
+    ScheduleGA algo(params);
+    algo.SetTracer(&tracer);
+    algo.Start(data);
+
+    std::ostringstream os;
+    tracer.WriteChromeTrace(os);
+    const std::string trace = os.str();
+
+    auto occurrences = [&](const std::string& pattern)
+    {
+        std::size_t count = 0;
+        for(auto pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1))
+            ++count;
+
+        return count;
+    };
+
+    REQUIRE(trace.starts_with("{\"traceEvents\":["));
+    REQUIRE(occurrences("\"ph\":\"B\"") == occurrences("\"ph\":\"E\""));
+    REQUIRE(occurrences("\"ph\":\"B\"") * 2 == tracer.EventsCount());
+    REQUIRE(occurrences("{\"name\":\"generation\",\"ph\":\"B\"") == 5);
+    REQUIRE(occurrences("{\"name\":\"crossover\",\"ph\":\"B\"") == 5);
+    REQUIRE(occurrences("{\"name\":\"natural selection\",\"ph\":\"B\"") == 5);
+    REQUIRE(occurrences("{\"name\":\"mutate\",\"ph\":\"B\"") >= 5);
+    REQUIRE(occurrences("{\"name\":\"evaluate\",\"ph\":\"B\"") >= 5);
+
+    // one thread recording into two tracers alternately keeps a single row in each of them
+    ScheduleTracer first;
+    ScheduleTracer second;
+    for(int i = 0; i < 3; ++i)
+    {
+        ScheduleTraceScope firstScope(&first, "first");
+        ScheduleTraceScope secondScope(&second, "second");
+    }
+
+    for(const ScheduleTracer* pTracer : {&first, &second})
+    {
+        std::ostringstream alternating;
+        pTracer->WriteChromeTrace(alternating);
+        REQUIRE(pTracer->EventsCount() == 6);
+        REQUIRE(alternating.str().find("\"tid\":2") == std::string::npos);
+    }
+}
+
+TEST_CASE("Memory report and budget", "[ScheduleGA]")
+{
+    std::mt19937 gen(23);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params{
+        .IndividualsCount = 40,
+        .IterationsCount = 3,
+        .SelectionCount = 5,
+        .CrossoverCount = 3,
+        .MutationChance = 50
+    };
+
+    {
+        ScheduleGA algo(params);
+        const auto statistics = algo.Start(data);
+        const auto& memory = statistics.Memory;
+
+        REQUIRE(memory.IndividualsCount == 40);
+        REQUIRE(memory.IndividualBytes == algo.Individuals().front().MemoryUsage());
+        REQUIRE(memory.PopulationBytes == 40 * memory.IndividualBytes);
+        REQUIRE(memory.ScheduleDataBytes == data.MemoryUsage());
+        REQUIRE(memory.ScratchBytesPerThread > 0);
+        REQUIRE(memory.TotalBytes() > memory.PopulationBytes);
+    }
+
+    const auto fullReport = ScheduleGA(params).ProjectMemory(data, params.IndividualsCount);
+    params.MemoryBudget = fullReport.TotalBytes() - 10 * fullReport.IndividualBytes;
+    REQUIRE_THROWS_AS(ScheduleGA(params).Start(data), std::runtime_error);
+
+    params.ShrinkPopulationToBudget = true;
+    {
+        ScheduleGA algo(params);
+        const auto statistics = algo.Start(data);
+        REQUIRE(algo.Individuals().size() == 30);
+        REQUIRE(statistics.Memory.TotalBytes() <= params.MemoryBudget);
+    }
+
+    params.MemoryBudget = fullReport.ScheduleDataBytes;
+    REQUIRE_THROWS_AS(ScheduleGA(params).Start(data), std::runtime_error);
+}
+
+TEST_CASE("Day masks evaluation is identical to sorting evaluation", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(29);
+    for(int instance = 0; instance < 20; ++instance)
+    {
+        // few lessons and buildings, so that requests often share lessons and change buildings
+        const auto requests = MakeRandomRequests(50, gen);
+        const ScheduleData data{requests, {}};
+
+        std::uniform_int_distribution<std::size_t> lessonsDist(0, MAX_LESSONS_COUNT + 2);
+        std::uniform_int_distribution<std::size_t> buildingsDist(0, 3);
+        for(int sample = 0; sample < 20; ++sample)
+        {
+            std::vector<std::size_t> lessons(requests.size());
+            std::vector<ClassroomAddress> classrooms(requests.size());
+            for(std::size_t r = 0; r < requests.size(); ++r)
+            {
+                const std::size_t lesson = lessonsDist(gen) % (sample < 10 ? MAX_LESSONS_COUNT + 2 : 12);
+                lessons[r] = lesson < MAX_LESSONS_COUNT ? lesson : std::numeric_limits<std::size_t>::max();
+
+                const std::size_t building = buildingsDist(gen);
+                classrooms[r] = building == 3 ? ClassroomAddress::NoClassroom() : ClassroomAddress(building, r);
+            }
+
+            const ScheduleChromosomes chromosomes(std::move(lessons), std::move(classrooms));
+            REQUIRE(Evaluate(chromosomes, data) == ReferenceEvaluate(chromosomes, data));
+        }
+
+        std::random_device randomDevice;
+        const ScheduleIndividual individual(randomDevice, &data);
+        REQUIRE(Evaluate(individual.Chromosomes(), data) == ReferenceEvaluate(individual.Chromosomes(), data));
+    }
+}
+
+TEST_CASE("Exporter writes every view in every format", "[ScheduleExport]")
+{
+    const std::vector weekDays{true, true, true, true, true, true};
+    const std::vector requests {
+        // [id, professor, complexity, weekDays, groups, classrooms]
+        SubjectRequest(0, 1, 1, weekDays, {0, 1}, {{0, 1}}),
+        SubjectRequest(1, 2, 1, weekDays, {1},    {{0, 2}}),
+        SubjectRequest(2, 1, 1, weekDays, {2},    {{1, 1}}),
+        SubjectRequest(3, 3, 1, weekDays, {0},    {})
+    };
+    const ScheduleData data{requests, {}};
+
+    // request 3 is not placed
+    const ScheduleChromosomes chromosomes(std::vector<std::size_t>{8, 0, 0, std::numeric_limits<std::size_t>::max()},
+                                          std::vector<ClassroomAddress>{{0, 1}, {0, 2}, {1, 1}, ClassroomAddress::NoClassroom()});
+
+    const ScheduleSlots slots(chromosomes);
+    REQUIRE(std::ranges::equal(slots.Requests(0), std::vector<std::size_t>{1, 2}));
+    REQUIRE(std::ranges::equal(slots.Requests(8), std::vector<std::size_t>{0}));
+    REQUIRE(slots.Requests(1).empty());
+
+    auto exportToString = [&](ScheduleExportView view, ScheduleExportFormat format)
+    {
+        std::ostringstream os;
+        ExportSchedule(chromosomes, data, ScheduleExportParams{.View = view, .Format = format}, os);
+        return os.str();
+    };
+
+    REQUIRE(exportToString(ScheduleExportView::Groups, ScheduleExportFormat::Csv) ==
+            "group,day,lesson,subject,professor,building,classroom,groups\n"
+            "0,1,1,0,1,0,1,0 1\n"
+            "1,0,0,1,2,0,2,1\n"
+            "1,1,1,0,1,0,1,0 1\n"
+            "2,0,0,2,1,1,1,2\n");
+
+    REQUIRE(exportToString(ScheduleExportView::Classrooms, ScheduleExportFormat::Json) ==
+            "[{\"classroom\":\"0-1\",\"lessons\":[{\"day\":1,\"lesson\":1,\"subject\":0,\"professor\":1,\"building\":0,\"classroom\":1,\"groups\":[0,1]}]},\n"
+            "{\"classroom\":\"0-2\",\"lessons\":[{\"day\":0,\"lesson\":0,\"subject\":1,\"professor\":2,\"building\":0,\"classroom\":2,\"groups\":[1]}]},\n"
+            "{\"classroom\":\"1-1\",\"lessons\":[{\"day\":0,\"lesson\":0,\"subject\":2,\"professor\":1,\"building\":1,\"classroom\":1,\"groups\":[2]}]}]\n");
+
+    const std::string calendar = exportToString(ScheduleExportView::Professors, ScheduleExportFormat::ICalendar);
+    REQUIRE(calendar.starts_with("BEGIN:VCALENDAR\r\n"));
+    REQUIRE(calendar.ends_with("END:VCALENDAR\r\n"));
+    // professor 1 has lesson 0 on monday and lesson 1 on tuesday
+    REQUIRE(calendar.find("UID:professor-1-2@schedulega\r\nDTSTAMP:20240902T000000Z\r\nDTSTART:20240902T083000\r\nDTEND:20240902T100000\r\n") != std::string::npos);
+    REQUIRE(calendar.find("UID:professor-1-0@schedulega\r\nDTSTAMP:20240902T000000Z\r\nDTSTART:20240903T101000\r\nDTEND:20240903T114000\r\n") != std::string::npos);
+
+    SECTION("Lessons without a classroom have empty fields")
+    {
+        // request 3 has no classrooms, place it to the lesson 2 of monday
+        const ScheduleChromosomes placed(std::vector<std::size_t>{8, 0, 0, 2},
+                                         std::vector<ClassroomAddress>{{0, 1}, {0, 2}, {1, 1}, ClassroomAddress::NoClassroom()});
+
+        auto exportPlaced = [&](ScheduleExportFormat format)
+        {
+            std::ostringstream os;
+            ExportSchedule(placed, data, ScheduleExportParams{.View = ScheduleExportView::Professors, .Format = format}, os);
+            return os.str();
+        };
+
+        REQUIRE(exportPlaced(ScheduleExportFormat::Csv).ends_with("3,0,2,3,3,,,0\n"));
+        REQUIRE(exportPlaced(ScheduleExportFormat::Json).ends_with(
+            "{\"professor\":\"3\",\"lessons\":[{\"day\":0,\"lesson\":2,\"subject\":3,\"professor\":3,\"building\":null,\"classroom\":null,\"groups\":[0]}]}]\n"));
+
+        const std::string placedCalendar = exportPlaced(ScheduleExportFormat::ICalendar);
+        REQUIRE(placedCalendar.find("SUMMARY:Subject 3\r\nCATEGORIES:professor 3\r\n") != std::string::npos);
+    }
+
+    SECTION("Parallel export matches sequential export")
+    {
+        for(auto format : {ScheduleExportFormat::Csv, ScheduleExportFormat::Json, ScheduleExportFormat::ICalendar})
+        {
+            std::ostringstream parallel;
+            ExportSchedule(chromosomes, data, ScheduleExportParams{.View = ScheduleExportView::Groups,
+                                                                   .Format = format,
+                                                                   .ParallelTimetablesThreshold = 0}, parallel);
+            REQUIRE(parallel.str() == exportToString(ScheduleExportView::Groups, format));
+        }
+    }
+}
+
+TEST_CASE("Fitness policy weights and disables terms", "[ScheduleFitness]")
+{
+    std::mt19937 gen(17);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleChromosomes chromosomes(data);
+    std::uniform_int_distribution<std::size_t> requestsDist(0, requests.size() - 1);
+    std::uniform_int_distribution<std::size_t> lessonsDist(0, MAX_LESSONS_COUNT);
+
+    auto term = [&](ScheduleFitnessWeights weights)
+    {
+        return Evaluate(chromosomes, data, RuntimeFitnessPolicy{weights});
+    };
+
+    constexpr ScheduleFitnessWeights noWeights{0, 0, 0, 0, 0, 0};
+    for(int move = 0; move < 100; ++move)
+    {
+        const std::size_t groupsGaps = term({.GroupsLessonsGaps = 1, .ProfessorsLessonsGaps = 0, .DayComplexity = 0,
+                                             .BuildingsChanges = 0, .NotPlacedLessons = 0, .NotPlacedClassrooms = 0});
+        const std::size_t professorsGaps = term({.GroupsLessonsGaps = 0, .ProfessorsLessonsGaps = 1, .DayComplexity = 0,
+                                                 .BuildingsChanges = 0, .NotPlacedLessons = 0, .NotPlacedClassrooms = 0});
+        const std::size_t complexity = term({.GroupsLessonsGaps = 0, .ProfessorsLessonsGaps = 0, .DayComplexity = 1,
+                                             .BuildingsChanges = 0, .NotPlacedLessons = 0, .NotPlacedClassrooms = 0});
+        const std::size_t buildings = term({.GroupsLessonsGaps = 0, .ProfessorsLessonsGaps = 0, .DayComplexity = 0,
+                                            .BuildingsChanges = 1, .NotPlacedLessons = 0, .NotPlacedClassrooms = 0});
+        const std::size_t notPlaced = term({.GroupsLessonsGaps = 0, .ProfessorsLessonsGaps = 0, .DayComplexity = 0,
+                                            .BuildingsChanges = 0, .NotPlacedLessons = 1, .NotPlacedClassrooms = 1});
+
+        const std::size_t expected = groupsGaps * 3 + professorsGaps * 2 + complexity * 4 + buildings * 64 + notPlaced * 100;
+        REQUIRE(Evaluate(chromosomes, data) == expected);
+        REQUIRE(Evaluate(chromosomes, data) == ReferenceEvaluate(chromosomes, data));
+        REQUIRE(term(ScheduleFitnessWeights{}) == expected);
+        REQUIRE(term(noWeights) == 0);
+        REQUIRE(Evaluate(chromosomes, data, NoBuildingsFitnessPolicy{}) == expected - buildings * 64);
+
+        const std::size_t r = requestsDist(gen);
+        const std::size_t lesson = lessonsDist(gen);
+        chromosomes.Lesson(r) = lesson < MAX_LESSONS_COUNT ? lesson : std::numeric_limits<std::size_t>::max();
+        const auto& classrooms = data.SubjectRequests().at(r).Classrooms();
+        if(!classrooms.empty())
+            chromosomes.Classroom(r) = classrooms.at(lesson % classrooms.size());
+    }
+}
+
+TEST_CASE("Incremental evaluation follows runtime fitness policy", "[ScheduleFitness]")
+{
+    std::mt19937 gen(23);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+    const RuntimeFitnessPolicy policy{{.GroupsLessonsGaps = 5, .ProfessorsLessonsGaps = 0, .DayComplexity = 1,
+                                       .BuildingsChanges = 0, .NotPlacedLessons = 50, .NotPlacedClassrooms = 20}};
+
+    ScheduleChromosomes chromosomes(data);
+    IncrementalEvaluator<DefaultScheduleCalendar, RuntimeFitnessPolicy> evaluator(chromosomes, data, policy);
+    REQUIRE(evaluator.Value() == Evaluate(chromosomes, data, policy));
+
+    std::uniform_int_distribution<std::size_t> requestsDist(0, requests.size() - 1);
+    std::uniform_int_distribution<std::size_t> lessonsDist(0, MAX_LESSONS_COUNT);
+    for(int move = 0; move < 200; ++move)
+    {
+        const std::size_t r = requestsDist(gen);
+        const std::size_t oldLesson = chromosomes.Lesson(r);
+        const ClassroomAddress oldClassroom = chromosomes.Classroom(r);
+
+        const std::size_t lesson = lessonsDist(gen);
+        chromosomes.Lesson(r) = lesson < MAX_LESSONS_COUNT ? lesson : std::numeric_limits<std::size_t>::max();
+
+        evaluator.Update(chromosomes, r, oldLesson, oldClassroom);
+        REQUIRE(evaluator.Value() == Evaluate(chromosomes, data, policy));
+    }
+}
+
+TEST_CASE("Genetic algorithm runs with fitness policies", "[ScheduleFitness]")
+{
+    std::mt19937 gen(29);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 20;
+    params.IterationsCount = 10;
+    params.SelectionCount = 5;
+    params.CrossoverCount = 5;
+
+    BasicScheduleGA<DefaultScheduleCalendar, NoBuildingsFitnessPolicy> noBuildings(params);
+    noBuildings.Start(data);
+    const auto& bestWithoutBuildings = noBuildings.Individuals().front();
+    REQUIRE(bestWithoutBuildings.Evaluate() == Evaluate(bestWithoutBuildings.Chromosomes(), data, NoBuildingsFitnessPolicy{}));
+
+    const RuntimeFitnessPolicy policy{{.GroupsLessonsGaps = 1, .ProfessorsLessonsGaps = 1, .DayComplexity = 0,
+                                       .BuildingsChanges = 8, .NotPlacedLessons = 10, .NotPlacedClassrooms = 10}};
+    BasicScheduleGA<DefaultScheduleCalendar, RuntimeFitnessPolicy> tuned(params, policy);
+    tuned.Start(data);
+    const auto& best = tuned.Individuals().front();
+    REQUIRE(best.Policy().Weights() == policy.Weights());
+    REQUIRE(best.Evaluate() == Evaluate(best.Chromosomes(), data, policy));
+}
+
+TEST_CASE("Adaptive rates stay within bounds", "[ScheduleGA]")
+{
+    std::mt19937 gen(31);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 30;
+    params.IterationsCount = 30;
+    params.SelectionCount = 10;
+    params.CrossoverCount = 10;
+    params.MutationChance = 50;
+
+    SECTION("Fixed rates are reported unchanged")
+    {
+        ScheduleGA algo(params);
+        const auto statistics = algo.Start(data);
+        REQUIRE(statistics.MutationChance == 50);
+        REQUIRE(statistics.CrossoverCount == 10);
+    }
+
+    SECTION("Adaptive rates are clamped to bounds")
+    {
+        params.AdaptiveRates = true;
+        params.MinMutationChance = 20;
+        params.MaxMutationChance = 60;
+        params.MinCrossoverCount = 5;
+        params.MaxCrossoverCount = 15;
+
+        ScheduleGA algo(params);
+        const auto statistics = algo.Start(data);
+        REQUIRE(statistics.MutationChance >= 20);
+        REQUIRE(statistics.MutationChance <= 60);
+        REQUIRE(statistics.CrossoverCount >= 5);
+        REQUIRE(statistics.CrossoverCount <= 15);
+        REQUIRE(std::ranges::is_sorted(algo.Individuals(), ScheduleIndividualLess()));
+    }
+
+    SECTION("Invalid bounds are rejected")
+    {
+        params.AdaptiveRates = true;
+        params.MinMutationChance = 70;
+        params.MaxMutationChance = 60;
+        REQUIRE_THROWS_AS(ScheduleGA(params), std::invalid_argument);
+
+        params.MinMutationChance = 0;
+        params.MinCrossoverCount = 40;
+        params.MaxCrossoverCount = 0;
+        REQUIRE_THROWS_AS(ScheduleGA(params), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Selection count must be within population", "[ScheduleGA]")
+{
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 10;
+
+    params.SelectionCount = 0;
+    REQUIRE_THROWS_AS(ScheduleGA(params), std::invalid_argument);
+
+    params.SelectionCount = 10;
+    REQUIRE_THROWS_AS(ScheduleGA(params), std::invalid_argument);
+
+    params.SelectionCount = 9;
+    REQUIRE_NOTHROW(ScheduleGA(params));
+}
+
+TEST_CASE("Graph coloring builds feasible and diverse schedules", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(37);
+    const auto requests = MakeRandomRequests(80, gen);
+    const ScheduleData data{requests, {SubjectWithAddress(3, 2 * MAX_LESSONS_PER_DAY + 1)}};
+
+    std::mt19937 firstGen(1);
+    std::mt19937 secondGen(2);
+    const ScheduleChromosomes first(data, firstGen);
+    const ScheduleChromosomes second(data, secondGen);
+    REQUIRE(first.Lessons() != second.Lessons());
+
+    for(const ScheduleChromosomes* pChromosomes : {&first, &second})
+    {
+        const auto& chromosomes = *pChromosomes;
+        REQUIRE(chromosomes.Lesson(3) == 2 * MAX_LESSONS_PER_DAY + 1);
+        for(std::size_t r = 0; r < requests.size(); ++r)
+        {
+            const std::size_t lesson = chromosomes.Lesson(r);
+            if(lesson == std::numeric_limits<std::size_t>::max())
+                continue;
+
+            REQUIRE(data.RequestedLessons(r).Test(lesson));
+            for(std::size_t other = r + 1; other < requests.size(); ++other)
+            {
+                if(chromosomes.Lesson(other) != lesson)
+                    continue;
+
+                REQUIRE_FALSE(data.RequestsConflicts(r, other));
+                if(chromosomes.Classroom(r) != ClassroomAddress::Any() && chromosomes.Classroom(r) != ClassroomAddress::NoClassroom())
+                    REQUIRE(chromosomes.Classroom(r) != chromosomes.Classroom(other));
+            }
+        }
+    }
+}
+
+TEST_CASE("Genetic algorithm starts from graph coloring population", "[ScheduleGA]")
+{
+    std::mt19937 gen(41);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 30;
+    params.IterationsCount = 0;
+    params.SelectionCount = 10;
+    params.CrossoverCount = 10;
+    params.Initialization = ScheduleGAInitialization::GraphColoring;
+
+    ScheduleGA algo(params);
+    algo.Start(data);
+
+    const auto& individuals = algo.Individuals();
+    REQUIRE(individuals.size() == 30);
+    REQUIRE(std::ranges::all_of(individuals, [](const ScheduleIndividual& individual){ return individual.Evaluated(); }));
+    REQUIRE(std::ranges::any_of(individuals, [&](const ScheduleIndividual& individual)
+    {
+        return individual.Chromosomes().Lessons() != individuals.front().Chromosomes().Lessons();
+    }));
+}
+
+TEST_CASE("Initial population individuals draw different random moves", "[ScheduleGA]")
+{
+    std::mt19937 gen(44);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 30;
+    params.IterationsCount = 0;
+    params.SelectionCount = 10;
+    params.CrossoverCount = 10;
+    params.Initialization = GENERATE(ScheduleGAInitialization::Greedy, ScheduleGAInitialization::GraphColoring);
+
+    ScheduleGA algo(params);
+    algo.Start(data);
+
+    // copies continue random streams of the individuals they were made of
+    auto movedRequests = [](ScheduleIndividual individual)
+    {
+        std::vector<std::size_t> result;
+        for(int i = 0; i < 20; ++i)
+            result.emplace_back(individual.RandomMove().Request);
+
+        return result;
+    };
+
+    const auto& individuals = algo.Individuals();
+    REQUIRE(movedRequests(individuals.front()) != movedRequests(individuals.back()));
+
+    // move assignment takes random generator of the assigned individual
+    ScheduleIndividual assigned = individuals.front();
+    assigned = ScheduleIndividual(individuals.back());
+    REQUIRE(movedRequests(assigned) == movedRequests(individuals.back()));
+}
+
+TEST_CASE("Repair places requests by ejecting a single blocking request", "[ScheduleChromosomes]")
+{
+    constexpr std::size_t noLesson = std::numeric_limits<std::size_t>::max();
+    const std::vector allDays{true, true, true, true, true, true};
+    const std::vector firstDay{true, false, false, false, false, false};
+
+    // request 0 of professor 1 is requested only on the first day, all its lessons are taken by other requests of professor 1
+    std::vector requests{SubjectRequest(0, 1, 1, firstDay, {0}, {})};
+    std::vector<std::size_t> lessons{noLesson};
+    std::vector<ClassroomAddress> classrooms{ClassroomAddress::NoClassroom()};
+    std::vector<SubjectWithAddress> lockedLessons;
+
+    const LessonsMask firstDayLessons = ScheduleData{requests, {}}.RequestedLessons(0);
+    for(std::size_t l = 0; l < MAX_LESSONS_COUNT; ++l)
+    {
+        if(!firstDayLessons.Test(l))
+            continue;
+
+        lockedLessons.emplace_back(requests.size(), l);
+        requests.emplace_back(requests.size(), 1, 1, allDays, std::vector<std::size_t>{requests.size()}, std::vector<ClassroomAddress>{});
+        lessons.emplace_back(l);
+        classrooms.emplace_back(ClassroomAddress::Any());
+    }
+
+    SECTION("Blocking request is moved to another lesson")
+    {
+        const ScheduleData data{requests, {}};
+        ScheduleChromosomes chromosomes(lessons, classrooms);
+        const std::size_t fitnessBefore = Evaluate(chromosomes, data);
+
+        REQUIRE(Repair(chromosomes, data) == 1);
+        REQUIRE(firstDayLessons.Test(chromosomes.Lesson(0)));
+        REQUIRE(chromosomes.Classroom(0) == ClassroomAddress::Any());
+        REQUIRE(std::ranges::count(chromosomes.Lessons(), noLesson) == 0);
+        REQUIRE(Evaluate(chromosomes, data) < fitnessBefore);
+        for(std::size_t r = 0; r < requests.size(); ++r)
+        {
+            for(std::size_t other = r + 1; other < requests.size(); ++other)
+                REQUIRE(chromosomes.Lesson(r) != chromosomes.Lesson(other));
+        }
+    }
+
+    SECTION("Locked requests are not moved")
+    {
+        const ScheduleData data{requests, lockedLessons};
+        ScheduleChromosomes chromosomes(lessons, classrooms);
+
+        REQUIRE(Repair(chromosomes, data) == 0);
+        REQUIRE(chromosomes.Lessons() == lessons);
+        REQUIRE(chromosomes.Classrooms() == classrooms);
+    }
+}
+
+TEST_CASE("Repair does not break placed requests", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(43);
+    for(std::size_t requestsCount : {100, 300})
+    {
+        const auto requests = MakeRandomRequests(requestsCount, gen);
+        const ScheduleData data{requests, {}};
+
+        ScheduleChromosomes chromosomes(data);
+        auto notPlaced = [&]
+        {
+            return std::ranges::count(chromosomes.Lessons(), std::numeric_limits<std::size_t>::max()) +
+                std::ranges::count(chromosomes.Classrooms(), ClassroomAddress::NoClassroom());
+        };
+
+        const auto notPlacedBefore = notPlaced();
+        const std::size_t repaired = Repair(chromosomes, data);
+        REQUIRE(notPlaced() <= notPlacedBefore - static_cast<std::ptrdiff_t>(repaired));
+
+        for(std::size_t r = 0; r < requests.size(); ++r)
+        {
+            const std::size_t lesson = chromosomes.Lesson(r);
+            if(lesson == std::numeric_limits<std::size_t>::max())
+                continue;
+
+            REQUIRE(data.RequestedLessons(r).Test(lesson));
+            for(std::size_t other = r + 1; other < requests.size(); ++other)
+            {
+                if(chromosomes.Lesson(other) != lesson)
+                    continue;
+
+                REQUIRE_FALSE(data.RequestsConflicts(r, other));
+                if(chromosomes.Classroom(r) != ClassroomAddress::Any() && chromosomes.Classroom(r) != ClassroomAddress::NoClassroom())
+                    REQUIRE(chromosomes.Classroom(r) != chromosomes.Classroom(other));
+            }
+        }
+    }
+}
+
+TEST_CASE("Genetic algorithm repairs individuals", "[ScheduleGA]")
+{
+    std::mt19937 gen(47);
+    const auto requests = MakeRandomRequests(120, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 20;
+    params.IterationsCount = 10;
+    params.SelectionCount = 5;
+    params.CrossoverCount = 5;
+    params.RepairIndividuals = true;
+
+    ScheduleChromosomes repaired(data);
+    Repair(repaired, data);
+
+    for(auto mode : {ScheduleGAMode::Generational, ScheduleGAMode::SteadyState})
+    {
+        params.Mode = mode;
+        ScheduleGA algo(params);
+        algo.Start(data);
+        REQUIRE(algo.Individuals().front().Evaluate() <= Evaluate(repaired, data));
+    }
+}
+
+
+TEST_CASE("Genetic algorithm runs with the same seed are repeatable", "[ScheduleGA]")
+{
+    std::mt19937 gen(48);
+    const auto requests = MakeRandomRequests(60, gen);
+    const ScheduleData data{requests, {}};
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 30;
+    params.IterationsCount = 20;
+    params.SelectionCount = 10;
+    params.CrossoverCount = 8;
+    params.SingleThreaded = true;
+    params.Initialization = GENERATE(ScheduleGAInitialization::Greedy, ScheduleGAInitialization::GraphColoring);
+    params.MigrationInterval = 5;
+    params.Seed = 12345;
+
+    // sends emigrants back, so that immigrants get random generators of the run
+    class LoopbackMigration : public BasicScheduleGAMigration<DefaultScheduleCalendar>
+    {
+    public:
+        void Emigrate(const ScheduleChromosomes& chromosomes, std::size_t) override { emigrants_.emplace_back(chromosomes); }
+        std::vector<ScheduleChromosomes> Immigrate() override { return std::exchange(emigrants_, {}); }
+
+    private:
+        std::vector<ScheduleChromosomes> emigrants_;
+    };
+
+    LoopbackMigration firstMigration;
+    ScheduleGA first(params);
+    first.SetMigration(&firstMigration);
+    first.Start(data);
+
+    LoopbackMigration secondMigration;
+    ScheduleGA second(params);
+    second.SetMigration(&secondMigration);
+    second.Start(data);
+
+    REQUIRE(first.Individuals().size() == second.Individuals().size());
+    for(std::size_t i = 0; i < first.Individuals().size(); ++i)
+    {
+        REQUIRE(first.Individuals()[i].Chromosomes().Lessons() == second.Individuals()[i].Chromosomes().Lessons());
+        REQUIRE(first.Individuals()[i].Evaluate() == second.Individuals()[i].Evaluate());
+    }
+
+    ScheduleSAParams saParams = ScheduleSA::DefaultParams();
+    saParams.ChainsCount = 3;
+    saParams.IterationsCount = 500;
+    saParams.Seed = 12345;
+
+    ScheduleSA firstSA(saParams);
+    firstSA.Start(data);
+
+    ScheduleSA secondSA(saParams);
+    secondSA.Start(data);
+
+    for(std::size_t i = 0; i < firstSA.Individuals().size(); ++i)
+        REQUIRE(firstSA.Individuals()[i].Chromosomes().Lessons() == secondSA.Individuals()[i].Chromosomes().Lessons());
+}
+
+TEST_CASE("Detailed evaluation explains the scalar score", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(49);
+    const auto requests = MakeRandomRequests(80, gen);
+    const ScheduleData data{requests, {}};
+
+    const auto& professorsRequests = data.ProfessorsRequests();
+    const auto& groupsRequests = data.GroupsRequests();
+    auto professorIndex = [&](std::size_t id)
+    {
+        for(std::size_t p = 0; p < professorsRequests.size(); ++p)
+        {
+            if(data.ProfessorID(p) == id)
+                return p;
+        }
+
+        FAIL("unknown professor " << id);
+        return std::size_t{0};
+    };
+    auto groupIndex = [&](std::size_t id)
+    {
+        for(std::size_t g = 0; g < groupsRequests.size(); ++g)
+        {
+            if(data.GroupID(g) == id)
+                return g;
+        }
+
+        FAIL("unknown group " << id);
+        return std::size_t{0};
+    };
+
+    RuntimeFitnessPolicy noBuildings;
+    noBuildings.Values.BuildingsChanges = 0;
+
+    for(int attempt = 0; attempt < 20; ++attempt)
+    {
+        const ScheduleChromosomes chromosomes(data, gen);
+        const ScheduleEvaluation evaluation = EvaluateDetailed(chromosomes, data);
+        REQUIRE(evaluation.Fitness == Evaluate(chromosomes, data));
+        REQUIRE(evaluation.Fitness == ReferenceEvaluate(chromosomes, data));
+
+        std::size_t professorsLessonsGaps = 0;
+        for(const auto& professorRequests : professorsRequests)
+            professorsLessonsGaps = std::max(professorsLessonsGaps, ReferenceProfessorLessonsGaps(chromosomes, professorRequests));
+
+        GroupEvaluation groups;
+        for(const auto& groupRequests : groupsRequests)
+        {
+            const GroupEvaluation group = ReferenceGroupEvaluation(chromosomes, data, groupRequests);
+            groups.LessonsGaps = std::max(groups.LessonsGaps, group.LessonsGaps);
+            groups.DayComplexity = std::max(groups.DayComplexity, group.DayComplexity);
+            groups.BuildingsChanges = std::max(groups.BuildingsChanges, group.BuildingsChanges);
+        }
+
+        REQUIRE(evaluation.ProfessorsLessonsGaps == professorsLessonsGaps);
+        REQUIRE(evaluation.GroupsLessonsGaps == groups.LessonsGaps);
+        REQUIRE(evaluation.DayComplexity == groups.DayComplexity);
+        REQUIRE(evaluation.BuildingsChanges == groups.BuildingsChanges);
+        REQUIRE(evaluation.NotPlacedLessons == static_cast<std::size_t>(std::ranges::count(chromosomes.Lessons(), std::numeric_limits<std::size_t>::max())));
+
+        // offenders give their terms
+        if(evaluation.ProfessorsLessonsGaps > 0)
+            REQUIRE(ReferenceProfessorLessonsGaps(chromosomes, professorsRequests[professorIndex(evaluation.LessonsGapsProfessor)]) == evaluation.ProfessorsLessonsGaps);
+        else
+            REQUIRE(evaluation.LessonsGapsProfessor == NO_OFFENDER);
+
+        if(evaluation.GroupsLessonsGaps > 0)
+            REQUIRE(ReferenceGroupEvaluation(chromosomes, data, groupsRequests[groupIndex(evaluation.LessonsGapsGroup)]).LessonsGaps == evaluation.GroupsLessonsGaps);
+
+        if(evaluation.DayComplexity > 0)
+            REQUIRE(ReferenceGroupEvaluation(chromosomes, data, groupsRequests[groupIndex(evaluation.DayComplexityGroup)]).DayComplexity == evaluation.DayComplexity);
+
+        if(evaluation.BuildingsChanges > 0)
+            REQUIRE(ReferenceGroupEvaluation(chromosomes, data, groupsRequests[groupIndex(evaluation.BuildingsChangesGroup)]).BuildingsChanges == evaluation.BuildingsChanges);
+        else
+            REQUIRE(evaluation.BuildingsChangesGroup == NO_OFFENDER);
+
+        // disabled terms are not computed
+        const ScheduleEvaluation weighted = EvaluateDetailed(chromosomes, data, noBuildings);
+        REQUIRE(weighted.Fitness == Evaluate(chromosomes, data, noBuildings));
+        REQUIRE(weighted.BuildingsChanges == 0);
+        REQUIRE(weighted.BuildingsChangesGroup == NO_OFFENDER);
+        REQUIRE(weighted.DayComplexity == evaluation.DayComplexity);
+    }
+
+    ScheduleGAParams params = ScheduleGA::DefaultParams();
+    params.IndividualsCount = 20;
+    params.IterationsCount = 10;
+    params.SelectionCount = 5;
+    params.CrossoverCount = 5;
+
+    ScheduleGA algo(params);
+    const auto statistics = algo.Start(data);
+    REQUIRE(statistics.BestEvaluation.Fitness == algo.Individuals().front().Evaluate());
+}
+
+TEST_CASE("Chromosomes copies share genes until the first change", "[ScheduleChromosomes]")
+{
+    std::mt19937 gen(50);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data{requests, {}};
+
+    const ScheduleChromosomes original(data);
+    ScheduleChromosomes copy = original;
+    REQUIRE(copy.SharesGenes());
+    REQUIRE(original.SharesGenes());
+    REQUIRE(&copy.Lessons() == &original.Lessons());
+
+    // reading through const chromosomes does not clone genes
+    REQUIRE(std::as_const(copy).Lesson(0) == original.Lesson(0));
+    REQUIRE(copy.SharesGenes());
+
+    const std::size_t originalLesson = original.Lesson(0);
+    copy.Lesson(0) = originalLesson + 1;
+    REQUIRE(original.Lesson(0) == originalLesson);
+    REQUIRE(copy.Lesson(0) == originalLesson + 1);
+    REQUIRE(&copy.Lessons() != &original.Lessons());
+    // classrooms are still shared until they are changed
+    REQUIRE(&copy.Classrooms() == &original.Classrooms());
+
+    const ClassroomAddress originalClassroom = original.Classroom(0);
+    copy.Classroom(0) = originalClassroom == ClassroomAddress::Any() ? ClassroomAddress::NoClassroom() : ClassroomAddress::Any();
+    REQUIRE(original.Classroom(0) == originalClassroom);
+    REQUIRE(copy.Classroom(0) != originalClassroom);
+    REQUIRE_FALSE(copy.SharesGenes());
+    REQUIRE_FALSE(original.SharesGenes());
+
+    // moved-from chromosomes stay valid
+    ScheduleChromosomes moved = std::move(copy);
+    REQUIRE(copy.Lessons() == moved.Lessons());
+    copy.Lesson(1) = originalLesson;
+    REQUIRE(moved.Lesson(0) == originalLesson + 1);
+
+    // individuals built from copies of one schedule evaluate and mutate independently
+    std::random_device randomDevice;
+    ScheduleIndividual first(randomDevice, &data, original);
+    ScheduleIndividual second = first;
+    REQUIRE(second.Chromosomes().SharesGenes());
+    for(int i = 0; i < 100; ++i)
+        second.Mutate();
+
+    REQUIRE(first.Chromosomes().Lessons() == original.Lessons());
+    REQUIRE(first.Chromosomes().Classrooms() == original.Classrooms());
+    REQUIRE(second.Evaluate() == Evaluate(second.Chromosomes(), data));
+
+    // local search which keeps no move leaves genes shared, near a local optimum most moves are rejected
+    first.LocalSearch(2000);
+    std::size_t rejectedSearches = 0;
+    for(int i = 0; i < 50; ++i)
+    {
+        ScheduleIndividual elite = first;
+        if(elite.LocalSearch(1) > 0)
+            continue;
+
+        ++rejectedSearches;
+        REQUIRE(elite.Chromosomes().SharesGenes());
+        REQUIRE(elite.Evaluate() == first.Evaluate());
+    }
+
+    REQUIRE(rejectedSearches > 0);
+}
+
+// Blocking line client of ScheduleDaemon
+class DaemonTestClient
+{
+public:
+    explicit DaemonTestClient(const std::string& socketPath)
+        : fd_(socket(AF_UNIX, SOCK_STREAM, 0))
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::ranges::copy(socketPath, address.sun_path);
+        REQUIRE(connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    }
+
+    ~DaemonTestClient() { close(fd_); }
+
+    void Send(const std::string& line)
+    {
+        const std::string message = line + '\n';
+        REQUIRE(send(fd_, message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size()));
+    }
+
+    std::string ReadLine()
+    {
+        std::string line;
+        for(char c = 0; recv(fd_, &c, 1, 0) == 1 && c != '\n';)
+            line += c;
+
+        return line;
+    }
+
+    // skips progress lines
+    std::string ReadReply()
+    {
+        std::string line = ReadLine();
+        while(line.starts_with("progress "))
+            line = ReadLine();
+
+        return line;
+    }
+
+private:
+    int fd_;
+};
+
+static std::string FormatDaemonRequest(const SubjectRequest& request)
+{
+    std::string line = std::to_string(request.ID()) + ' ' + std::to_string(request.Professor()) + ' ' + std::to_string(request.Complexity()) + ' ';
+    for(std::size_t d = 0; d < DAYS_IN_SCHEDULE_WEEK; ++d)
+        line += request.RequestedWeekDay(d) ? '1' : '0';
+
+    line += ' ';
+    for(std::size_t g : request.Groups())
+        line += std::to_string(g) + ',';
+
+    line.back() = ' ';
+    if(request.Classrooms().empty())
+        return line + '-';
+
+    for(const auto& classroom : request.Classrooms())
+        line += std::to_string(classroom.Building) + ':' + std::to_string(classroom.Classroom) + ',';
+
+    line.pop_back();
+    return line;
+}
+
+static std::size_t ParseDaemonAddress(const std::string& token)
+{
+    return token == "-" ? std::numeric_limits<std::size_t>::max() : std::stoull(token);
+}
+
+// returns fitness from the result line together with the schedule
+static std::pair<std::size_t, ScheduleChromosomes> ParseDaemonResult(const std::string& line)
+{
+    std::istringstream is(line);
+    std::string token;
+    std::size_t fitness = 0;
+    is >> token >> token >> fitness;
+
+    std::vector<std::size_t> lessons;
+    std::vector<ClassroomAddress> classrooms;
+    for(std::size_t previousID = 0; is >> token;)
+    {
+        // addresses are labelled with request IDs in ascending order, which is the order of requests in ScheduleData
+        const auto equals = token.find('=');
+        const std::size_t id = std::stoull(token.substr(0, equals));
+        REQUIRE((lessons.empty() || id > previousID));
+        previousID = id;
+
+        token.erase(0, equals + 1);
+        const auto firstColon = token.find(':');
+        const auto secondColon = token.find(':', firstColon + 1);
+        lessons.emplace_back(ParseDaemonAddress(token.substr(0, firstColon)));
+        classrooms.emplace_back(ParseDaemonAddress(token.substr(firstColon + 1, secondColon - firstColon - 1)),
+                                ParseDaemonAddress(token.substr(secondColon + 1)));
+    }
+
+    return {fitness, ScheduleChromosomes(std::move(lessons), std::move(classrooms))};
+}
+
+TEST_CASE("Daemon solves loaded datasets", "[ScheduleDaemon]")
+{
+    std::mt19937 gen(46);
+    const auto requests = MakeRandomRequests(40, gen);
+    const ScheduleData data(requests, {});
+
+    ScheduleDaemonParams params;
+    params.SocketPath = "/tmp/ScheduleDaemon_test_" + std::to_string(getpid()) + ".sock";
+    params.ConcurrentJobs = 2;
+    params.ProgressInterval = 5;
+    params.GAParams = ScheduleGA::DefaultParams();
+    params.GAParams.IndividualsCount = 20;
+    params.GAParams.SelectionCount = 8;
+    params.GAParams.CrossoverCount = 4;
+
+    ScheduleDaemon daemon(params);
+    daemon.Start();
+
+    DaemonTestClient client(params.SocketPath);
+    client.Send("load dataset " + std::to_string(requests.size()) + " 0");
+    for(const auto& request : requests)
+        client.Send(FormatDaemonRequest(request));
+
+    REQUIRE(client.ReadReply() == "loaded dataset " + std::to_string(requests.size()));
+
+    SECTION("Result matches evaluation of the schedule")
+    {
+        client.Send("solve dataset 20");
+        REQUIRE(client.ReadReply() == "queued 1");
+
+        const auto line = client.ReadReply();
+        REQUIRE(line.starts_with("result 1 "));
+
+        const auto [fitness, chromosomes] = ParseDaemonResult(line);
+        REQUIRE(chromosomes.Lessons().size() == requests.size());
+        REQUIRE(fitness == Evaluate(chromosomes, data));
+
+        client.Send("resolve dataset 10");
+        REQUIRE(client.ReadReply() == "queued 2");
+
+        const auto resolved = ParseDaemonResult(client.ReadReply());
+        REQUIRE(resolved.first <= fitness);
+    }
+    SECTION("What-if keeps additional locked lessons without changing the dataset")
+    {
+        client.Send("whatif dataset 10 1");
+        client.Send("0 7");
+        REQUIRE(client.ReadReply() == "queued 1");
+
+        const auto [fitness, chromosomes] = ParseDaemonResult(client.ReadReply());
+        REQUIRE(chromosomes.Lesson(0) == 7);
+        REQUIRE(fitness == Evaluate(chromosomes, ScheduleData(requests, {SubjectWithAddress(0, 7)})));
+    }
+    SECTION("Invalid commands are reported without closing the connection")
+    {
+        client.Send("solve unknown 10");
+        REQUIRE(client.ReadReply().starts_with("error "));
+
+        client.Send("stop 100");
+        REQUIRE(client.ReadReply().starts_with("error "));
+
+        client.Send("unload dataset");
+        REQUIRE(client.ReadReply() == "unloaded dataset");
+    }
+    SECTION("Results are labelled with request IDs")
+    {
+        // requests are sent in reverse order with one of them repeated
+        client.Send("load shuffled " + std::to_string(requests.size() + 1) + " 0");
+        for(auto it = requests.rbegin(); it != requests.rend(); ++it)
+            client.Send(FormatDaemonRequest(*it));
+
+        client.Send(FormatDaemonRequest(requests.front()));
+        REQUIRE(client.ReadReply() == "loaded shuffled " + std::to_string(requests.size()));
+
+        client.Send("whatif shuffled 10 1");
+        client.Send(std::to_string(requests.back().ID()) + " 7");
+        REQUIRE(client.ReadReply() == "queued 1");
+
+        const auto line = client.ReadReply();
+        REQUIRE(line.find(' ' + std::to_string(requests.back().ID()) + "=7:") != std::string::npos);
+
+        const auto [fitness, chromosomes] = ParseDaemonResult(line);
+        REQUIRE(chromosomes.Lessons().size() == requests.size());
+        REQUIRE(fitness == Evaluate(chromosomes, ScheduleData(requests, {SubjectWithAddress(requests.back().ID(), 7)})));
+    }
+    SECTION("Locked lessons outside of calendar are rejected")
+    {
+        client.Send("whatif dataset 10 2");
+        client.Send("5 500");
+        client.Send("0 7");
+        REQUIRE(client.ReadReply().starts_with("error "));
+
+        client.Send("load other 1 1");
+        client.Send(FormatDaemonRequest(requests.front()));
+        client.Send(std::to_string(requests.front().ID()) + ' ' + std::to_string(DefaultScheduleCalendar::MaxLessonsCount));
+        REQUIRE(client.ReadReply().starts_with("error "));
+
+        // daemon keeps serving, all lines of rejected commands were consumed
+        client.Send("solve dataset 5");
+        REQUIRE(client.ReadReply() == "queued 1");
+        REQUIRE(client.ReadReply().starts_with("result 1 "));
+    }
+
+    daemon.Stop();
+}